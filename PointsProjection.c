@@ -15,11 +15,44 @@
  *   - Minutes trend (expected minutes vs season minutes)
  *   - Pace factor for matchup
  *   - Back-to-back penalty
+ *   - Blowout risk from the spread
+ *   - Usage shifts from absent teammates
  *
- * Everything is tunable in WEIGHTS & BASELINES.
+ * Everything is tunable in WEIGHTS & BASELINES. The global W_* weights can
+ * be rescaled per position / player archetype in WEIGHT PROFILES.
+ *
+ * Usage:
+ *   points_model [--curves <file>]            interactive, one player
+ *   points_model [--curves <file>] <command>  slate / streaming tools;
+ *                                             see COMMANDS at the bottom
+ *   --devig mult|power|shin                   vig removal for market prices
  */
 
+#define _GNU_SOURCE                /* CPU affinity (NUMA SHARDS) */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
 
 /*======================== TUNABLE WEIGHTS & CAPS ========================*/
 
@@ -39,6 +72,46 @@ static const double W_MINUTES_TREND    = 0.10;  /* expected minutes vs season mi
 static const double W_PACE             = 0.06;  /* matchup pace vs league average pace (relative) */
 static const double W_B2B_PENALTY      = 0.03;  /* subtract up to 3% if on B2B */
 
+/* Blowout factor (see BLOWOUT FACTOR): final margin ~ Normal(-spread, MARGIN_SD) */
+static const double W_BLOWOUT          = 1.00;  /* per-minute scoring shift from the margin distribution */
+static const double MARGIN_SD          = 12.0;  /* std dev of final margin around the spread */
+static const double BLOWOUT_CLOSE      = 5.0;   /* |margin| under which it's crunch time */
+static const double BLOWOUT_START      = 10.0;  /* |margin| where rotations start to change */
+static const double BLOWOUT_FULL       = 25.0;  /* |margin| where garbage time is fully on */
+static const double STARTER_BLOWOUT_MIN  = 0.78; /* starter minutes factor in a full blowout */
+static const double BENCH_BLOWOUT_MIN    = 1.30; /* bench minutes factor in a full blowout */
+static const double STARTER_CLOSE_RATE   = 1.03; /* starter points per minute in crunch time */
+static const double STARTER_BLOWOUT_RATE = 0.97; /* starter points per minute in a blowout */
+static const double BENCH_BLOWOUT_RATE   = 1.06; /* bench points per minute in garbage time */
+
+/* Overtime (see OVERTIME) */
+static const double OT_BASE_RATE       = 0.06;  /* P(OT) for a pick'em at the league-average total */
+static const double OT_REPEAT          = 0.12;  /* P(an OT period ends tied again) */
+static const double OT_MINUTES         = 5.0;
+static const double OT_STARTER_BOOST   = 0.30;  /* starters' extra share of OT minutes */
+
+/* Simulation (see SIMULATION) */
+static const double SIM_DISPERSION     = 2.2;   /* points variance / mean */
+
+/* Teammate absences (see TEAMMATE ABSENCES) */
+static const double W_USAGE_SHIFT      = 0.80;  /* share of a usage-rate gain that turns into points */
+static const double MAX_PLAYER_MINUTES = 42.0;  /* cap when absorbing an absent teammate's minutes */
+static const double USAGE_MULT_MAX     = 1.35;  /* cap on the usage multiplier */
+
+/* Minutes sub-model (see MINUTES MODEL) */
+static const double W_MIN_RECENT       = 0.65;  /* recent rotation minutes vs season minutes */
+static const double MIN_REST_B2B       = 0.03;  /* minutes lost on 0 days rest */
+static const double MIN_REST_EXTRA     = 0.01;  /* minutes gained on 2+ days rest */
+static const double MIN_FOUL_BASE      = 4.0;   /* fouls per 36 that carry no foul-trouble risk */
+static const double MIN_FOUL_SLOPE     = 0.03;  /* minutes lost per extra foul per 36 */
+static const double MIN_INJURY_SLOPE   = 0.015; /* minutes lost per game missed injured (last 10) */
+
+/* Live mode (see LIVE UPDATES) */
+static const double LIVE_PRIOR_MINUTES = 24.0;  /* weight of the pregame rate, in minutes played */
+static const double LIVE_FOUL_TROUBLE  = 0.15;  /* remaining minutes lost per foul above pace */
+static const double REGULATION_SECONDS = 2880.0;
+static const int    FOUL_OUT_LIMIT     = 6;
+
 /* Baselines (edit as you see fit) */
 static const double LEAGUE_AVG_GAME_TOTAL      = 229.0;
 static const double LEAGUE_AVG_TEAM_TOTAL      = 114.5;
@@ -54,6 +127,378 @@ static double clamp(double x, double lo, double hi) {
     return x < lo ? lo : (x > hi ? hi : x);
 }
 
+/*======================== WEIGHT PROFILES ========================*/
+
+/* One full set of weights. Row ARCH_GLOBAL of WEIGHT_PROFILES is exactly the
+ * W_* constants above; every other row is the global set rescaled per factor.
+ * The batch kernel gathers a row by each player's archetype index. */
+typedef struct {
+    double base_line;
+    double base_season_avg;
+    double home_away;
+    double game_total;
+    double team_total;
+    double def_vs_pos;
+    double recent_form;
+    double minutes_trend;
+    double pace;
+    double b2b_penalty;
+} WeightProfile;
+
+typedef enum {
+    ARCH_GLOBAL = 0,   /* unknown player / no position: plain W_* weights */
+    ARCH_GUARD,
+    ARCH_WING,
+    ARCH_BIG,
+    ARCH_USAGE_GUARD,  /* high-usage lead guard */
+    ARCH_BENCH_GUARD,
+    ARCH_BENCH_BIG,
+    N_ARCHETYPES
+} Archetype;
+
+/* Per-archetype scale applied to the matching global weight (1.0 = same).
+ * Base blend weights are not rescaled. */
+typedef struct {
+    const char *name;
+    double home_away, game_total, team_total, def_vs_pos;
+    double recent_form, minutes_trend, pace, b2b_penalty;
+} ArchetypeScale;
+
+static const ArchetypeScale ARCHETYPE_SCALES[N_ARCHETYPES] = {
+    /*                 home  game  team  dvp   recent mins  pace  b2b */
+    { "global",        1.00, 1.00, 1.00, 1.00, 1.00,  1.00, 1.00, 1.00 },
+    { "guard",         1.00, 1.05, 1.05, 0.95, 1.00,  1.00, 1.10, 1.00 },
+    { "wing",          1.00, 1.00, 1.00, 1.05, 1.00,  1.00, 1.00, 1.00 },
+    { "big",           1.10, 0.90, 0.95, 1.15, 0.90,  1.00, 0.85, 1.10 },
+    { "usage_guard",   0.90, 1.10, 1.20, 0.80, 1.10,  0.85, 1.25, 0.90 },
+    { "bench_guard",   1.20, 1.00, 0.90, 1.00, 1.25,  1.35, 1.10, 1.20 },
+    { "bench_big",     1.20, 0.80, 0.85, 1.30, 1.10,  1.40, 0.70, 1.50 },
+};
+
+/* Position codes accepted in place of an archetype name */
+static const struct { const char *alias; Archetype arch; } ARCHETYPE_ALIASES[] = {
+    { "PG", ARCH_GUARD }, { "SG", ARCH_GUARD }, { "G",  ARCH_GUARD },
+    { "SF", ARCH_WING  }, { "GF", ARCH_WING  }, { "F",  ARCH_WING  },
+    { "PF", ARCH_BIG   }, { "FC", ARCH_BIG   }, { "C",  ARCH_BIG   },
+};
+
+static WeightProfile WEIGHT_PROFILES[N_ARCHETYPES];
+
+static void weights_init(void) {
+    for (int a = 0; a < N_ARCHETYPES; ++a) {
+        const ArchetypeScale *s = &ARCHETYPE_SCALES[a];
+        WeightProfile *w = &WEIGHT_PROFILES[a];
+        w->base_line       = W_BASE_LINE;
+        w->base_season_avg = W_BASE_SEASON_AVG;
+        w->home_away       = W_HOME_AWAY     * s->home_away;
+        w->game_total      = W_GAME_TOTAL    * s->game_total;
+        w->team_total      = W_TEAM_TOTAL    * s->team_total;
+        w->def_vs_pos      = W_DEF_VS_POS    * s->def_vs_pos;
+        w->recent_form     = W_RECENT_FORM   * s->recent_form;
+        w->minutes_trend   = W_MINUTES_TREND * s->minutes_trend;
+        w->pace            = W_PACE          * s->pace;
+        /* A negative penalty means "disabled", same as 0.0 */
+        w->b2b_penalty     = W_B2B_PENALTY > 0.0 ? W_B2B_PENALTY * s->b2b_penalty : 0.0;
+    }
+}
+
+/* Map a position code or archetype name to a profile row; anything we don't
+ * recognize falls back to the global profile. */
+static Archetype archetype_from_name(const char *s) {
+    if (!s) return ARCH_GLOBAL;
+    for (int a = 0; a < N_ARCHETYPES; ++a)
+        if (strcasecmp(s, ARCHETYPE_SCALES[a].name) == 0) return (Archetype)a;
+    for (size_t k = 0; k < sizeof(ARCHETYPE_ALIASES) / sizeof(ARCHETYPE_ALIASES[0]); ++k)
+        if (strcasecmp(s, ARCHETYPE_ALIASES[k].alias) == 0) return ARCHETYPE_ALIASES[k].arch;
+    return ARCH_GLOBAL;
+}
+
+static const WeightProfile *profile_for(int archetype) {
+    if (archetype < 0 || archetype >= N_ARCHETYPES) archetype = ARCH_GLOBAL;
+    return &WEIGHT_PROFILES[archetype];
+}
+
+/*======================== RESPONSE CURVES ========================*/
+
+/* By default each factor is linear in its relative deviation:
+ *     mult = 1 + rel * W
+ * A response curve replaces `rel` with g(rel), keeping the weight as an
+ * overall scale. Curves are knot lists (piecewise-linear or monotone cubic
+ * spline) read from a curve file and sampled once into a uniform-grid lookup
+ * table, so evaluating one costs an index, two gathers and a lerp. Beyond
+ * the last knot the curve continues with its end slope; put a flat final
+ * segment on a curve to make it saturate. */
+typedef enum {
+    FACTOR_GAME_TOTAL = 0,
+    FACTOR_TEAM_TOTAL,
+    FACTOR_DEF_VS_POS,
+    FACTOR_RECENT_FORM,
+    FACTOR_MINUTES_TREND,
+    FACTOR_PACE,
+    N_CURVE_FACTORS
+} CurveFactor;
+
+static const char *const CURVE_FACTOR_NAMES[N_CURVE_FACTORS] = {
+    "game_total", "team_total", "def_vs_pos", "recent_form", "minutes_trend", "pace",
+};
+
+#define CURVE_MAX_KNOTS 16
+#define CURVE_LUT_SIZE  64
+
+typedef struct {
+    int n;
+    int spline;                    /* 0 = piecewise-linear, 1 = monotone cubic */
+    double x[CURVE_MAX_KNOTS];
+    double y[CURVE_MAX_KNOTS];
+} ResponseCurve;
+
+typedef struct {
+    double lo;                     /* rel at grid point 0 */
+    double inv_step;               /* grid points per unit rel */
+    double y[CURVE_LUT_SIZE];
+} FactorLut;
+
+static FactorLut FACTOR_LUTS[N_CURVE_FACTORS];
+static int FACTOR_CURVES_ON = 0;   /* 0: plain linear factors, LUTs unused */
+
+/* Exact curve value; only used while building the tables. */
+static double curve_eval_exact(const ResponseCurve *c, double x) {
+    int k = 0;
+    if (x <= c->x[0]) k = 0;
+    else if (x >= c->x[c->n - 1]) k = c->n - 2;
+    else while (k < c->n - 2 && x > c->x[k + 1]) ++k;
+
+    double h = c->x[k + 1] - c->x[k];
+    double t = (x - c->x[k]) / h;
+    double d = (c->y[k + 1] - c->y[k]) / h;
+    if (!c->spline || t < 0.0 || t > 1.0) {
+        /* Linear inside the segment and for end-slope extrapolation */
+        return c->y[k] + t * (c->y[k + 1] - c->y[k]);
+    }
+
+    /* Fritsch-Carlson tangents keep the spline monotone between knots */
+    double m0, m1;
+    for (int e = 0; e < 2; ++e) {
+        int j = k + e;
+        double m;
+        if (j == 0 || j == c->n - 1) {
+            m = (c->y[j == 0 ? 1 : j] - c->y[j == 0 ? 0 : j - 1])
+              / (c->x[j == 0 ? 1 : j] - c->x[j == 0 ? 0 : j - 1]);
+        } else {
+            double dl = (c->y[j] - c->y[j - 1]) / (c->x[j] - c->x[j - 1]);
+            double dr = (c->y[j + 1] - c->y[j]) / (c->x[j + 1] - c->x[j]);
+            m = (dl * dr <= 0.0) ? 0.0 : 2.0 / (1.0 / dl + 1.0 / dr);
+        }
+        if (d == 0.0) m = 0.0;
+        if (e == 0) m0 = m; else m1 = m;
+    }
+    double t2 = t * t, t3 = t2 * t;
+    return (2 * t3 - 3 * t2 + 1) * c->y[k] + (t3 - 2 * t2 + t) * h * m0
+         + (-2 * t3 + 3 * t2) * c->y[k + 1] + (t3 - t2) * h * m1;
+}
+
+static void lut_build(FactorLut *l, const ResponseCurve *c) {
+    double lo = c->x[0], hi = c->x[c->n - 1];
+    l->lo = lo;
+    l->inv_step = (CURVE_LUT_SIZE - 1) / (hi - lo);
+    for (int k = 0; k < CURVE_LUT_SIZE; ++k)
+        l->y[k] = curve_eval_exact(c, lo + (hi - lo) * k / (CURVE_LUT_SIZE - 1));
+}
+
+/* Branch-free: the cell index is clamped, the fraction is not, so points
+ * outside the grid extrapolate along the first/last cell.
+ *
+ * Deliberately scalar, with no explicit gather path. The row loop in
+ * project_batch() does not vectorize anyway: it loads each row's weight
+ * profile through a pointer and does the blowout lookup. Gathering six
+ * table reads would still leave every other lane scalar. The table is 64
+ * doubles, so both reads hit L1, and an intrinsics path would need a
+ * second build flavour with its own parity check against project(). */
+static inline double lut_eval(const FactorLut *l, double x) {
+    double t = (x - l->lo) * l->inv_step;
+    double ft = floor(t);
+    ft = ft < 0.0 ? 0.0 : (ft > CURVE_LUT_SIZE - 2 ? CURVE_LUT_SIZE - 2 : ft);
+    int k = (int)ft;
+    double f = t - ft;
+    return l->y[k] + f * (l->y[k + 1] - l->y[k]);
+}
+
+/* g(rel) for the scalar path */
+static double response(CurveFactor f, double rel) {
+    return FACTOR_CURVES_ON ? lut_eval(&FACTOR_LUTS[f], rel) : rel;
+}
+
+/* Reset every factor to the identity response */
+static void curves_reset(void) {
+    ResponseCurve ident = { 2, 0, { -1.0, 1.0 }, { -1.0, 1.0 } };
+    for (int f = 0; f < N_CURVE_FACTORS; ++f) lut_build(&FACTOR_LUTS[f], &ident);
+}
+
+/* Install one curve line (modified in place). 1 = installed, 0 = blank
+ * or comment, -1 = malformed (reported against where / lineno). */
+static int curve_line_apply(char *line, const char *where, int lineno) {
+    char *tok = strtok(line, " \t\r\n");
+    if (!tok || tok[0] == '#') return 0;
+
+    int f = 0;
+    while (f < N_CURVE_FACTORS && strcmp(tok, CURVE_FACTOR_NAMES[f]) != 0) ++f;
+    char *kind = strtok(NULL, " \t\r\n");
+    if (f == N_CURVE_FACTORS || !kind) {
+        fprintf(stderr, "%s:%d: expected '<factor> <linear|spline> x:y ...'\n", where, lineno);
+        return -1;
+    }
+
+    ResponseCurve c;
+    memset(&c, 0, sizeof(c));
+    c.spline = strcmp(kind, "spline") == 0;
+    while ((tok = strtok(NULL, " \t\r\n")) && c.n < CURVE_MAX_KNOTS) {
+        if (sscanf(tok, "%lf:%lf", &c.x[c.n], &c.y[c.n]) != 2) break;
+        if (c.n > 0 && c.x[c.n] <= c.x[c.n - 1]) break;
+        ++c.n;
+    }
+    if (tok || c.n < 2) {
+        fprintf(stderr, "%s:%d: need 2..%d knots with increasing x\n", where, lineno, CURVE_MAX_KNOTS);
+        return -1;
+    }
+    lut_build(&FACTOR_LUTS[f], &c);
+    return 1;
+}
+
+/* Curve file, one curve per line:
+ *     <factor> <linear|spline> x:y x:y ...
+ * e.g. "pace spline -0.08:-0.12 -0.02:-0.02 0.02:0.02 0.08:0.14"
+ * Factors without a line keep the identity response. */
+static int curves_load(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) { perror(path); return -1; }
+
+    curves_reset();
+    char line[512];
+    int lineno = 0, rc = 0;
+    while (rc == 0 && fgets(line, sizeof(line), fp))
+        if (curve_line_apply(line, path, ++lineno) < 0) rc = -1;
+    fclose(fp);
+    if (rc == 0) FACTOR_CURVES_ON = 1;
+    return rc;
+}
+
+/*======================== BLOWOUT FACTOR ========================*/
+
+/* The spread sets a distribution for the team's final margin. Blowouts move
+ * minutes from starters to the bench; close games and garbage time change
+ * how many points each role scores per minute. For each spread on a 0.5-pt
+ * grid the expected minutes factor E[f(M)] and the per-minute scoring factor
+ * E[f(M) g(M)] / E[f(M)] are integrated once at startup, per role, and
+ * normalized to a pick'em game. Evaluating a player is then one table lerp
+ * between the starter and bench rows, O(1) and branch-free.
+ *
+ * The minutes factor feeds the minutes model (expected_minutes); the
+ * per-minute factor is the blowout multiplier in the projection, so the two
+ * never double count. */
+#define BLOWOUT_LUT_SIZE 81          /* spreads -20 .. +20 by 0.5 */
+#define ROLE_STARTER 0
+#define ROLE_BENCH   1
+
+typedef struct {
+    double lo, inv_step;
+    double minutes[2][BLOWOUT_LUT_SIZE];
+    double rate[2][BLOWOUT_LUT_SIZE];
+} BlowoutLut;
+
+static BlowoutLut BLOWOUT;
+
+/* 0 = pure bench (<= 18 mpg), 1 = pure starter (>= 32 mpg) */
+static inline double starter_share(double season_minutes) {
+    return clamp((season_minutes - 18.0) / 14.0, 0.0, 1.0);
+}
+
+/* Conditional curves for a given |margin| */
+static double blowout_minutes_curve(int role, double am) {
+    double t = clamp((am - BLOWOUT_START) / (BLOWOUT_FULL - BLOWOUT_START), 0.0, 1.0);
+    double full = role == ROLE_STARTER ? STARTER_BLOWOUT_MIN : BENCH_BLOWOUT_MIN;
+    return 1.0 + t * (full - 1.0);
+}
+
+static double blowout_rate_curve(int role, double am) {
+    double t = clamp((am - BLOWOUT_START) / (BLOWOUT_FULL - BLOWOUT_START), 0.0, 1.0);
+    if (role == ROLE_BENCH) return 1.0 + t * (BENCH_BLOWOUT_RATE - 1.0);
+    double close = clamp((BLOWOUT_START - am) / (BLOWOUT_START - BLOWOUT_CLOSE), 0.0, 1.0);
+    return 1.0 + close * (STARTER_CLOSE_RATE - 1.0) + t * (STARTER_BLOWOUT_RATE - 1.0);
+}
+
+static void blowout_init(void) {
+    const double dm = 0.25;
+    BLOWOUT.lo = -0.5 * (BLOWOUT_LUT_SIZE / 2);
+    BLOWOUT.inv_step = 2.0;
+
+    for (int role = 0; role < 2; ++role) {
+        for (int k = 0; k < BLOWOUT_LUT_SIZE; ++k) {
+            double mu = -(BLOWOUT.lo + k * 0.5);
+            double wsum = 0.0, em = 0.0, emr = 0.0;
+            for (double m = mu - 5.0 * MARGIN_SD; m <= mu + 5.0 * MARGIN_SD; m += dm) {
+                double z = (m - mu) / MARGIN_SD;
+                double w = exp(-0.5 * z * z);
+                double f = blowout_minutes_curve(role, fabs(m));
+                wsum += w;
+                em   += w * f;
+                emr  += w * f * blowout_rate_curve(role, fabs(m));
+            }
+            BLOWOUT.minutes[role][k] = em / wsum;
+            BLOWOUT.rate[role][k]    = emr / em;
+        }
+        double m0 = BLOWOUT.minutes[role][BLOWOUT_LUT_SIZE / 2];
+        double r0 = BLOWOUT.rate[role][BLOWOUT_LUT_SIZE / 2];
+        for (int k = 0; k < BLOWOUT_LUT_SIZE; ++k) {
+            BLOWOUT.minutes[role][k] /= m0;
+            BLOWOUT.rate[role][k]    /= r0;
+        }
+    }
+}
+
+/* Spreads past the grid clamp to its ends. */
+static inline void blowout_lookup(double spread, double starter, double *minutes, double *rate) {
+    double t = clamp((spread - BLOWOUT.lo) * BLOWOUT.inv_step, 0.0, BLOWOUT_LUT_SIZE - 1.0);
+    double ft = floor(t);
+    ft = ft > BLOWOUT_LUT_SIZE - 2 ? BLOWOUT_LUT_SIZE - 2 : ft;
+    int k = (int)ft;
+    double f = t - ft;
+    double sm = BLOWOUT.minutes[ROLE_STARTER][k] + f * (BLOWOUT.minutes[ROLE_STARTER][k + 1] - BLOWOUT.minutes[ROLE_STARTER][k]);
+    double bm = BLOWOUT.minutes[ROLE_BENCH][k]   + f * (BLOWOUT.minutes[ROLE_BENCH][k + 1]   - BLOWOUT.minutes[ROLE_BENCH][k]);
+    double sr = BLOWOUT.rate[ROLE_STARTER][k]    + f * (BLOWOUT.rate[ROLE_STARTER][k + 1]    - BLOWOUT.rate[ROLE_STARTER][k]);
+    double br = BLOWOUT.rate[ROLE_BENCH][k]      + f * (BLOWOUT.rate[ROLE_BENCH][k + 1]      - BLOWOUT.rate[ROLE_BENCH][k]);
+    *minutes = bm + starter * (sm - bm);
+    *rate    = br + starter * (sr - br);
+}
+
+/*======================== OVERTIME ========================*/
+
+/* A game goes to OT when regulation ends tied. With the final margin
+ * ~ Normal(-spread, sd) and sd growing with the total (more possessions,
+ * more variance), P(tie) is proportional to the margin density at 0:
+ *
+ *   P(OT) = OT_BASE_RATE * (sd0 / sd) * exp(-spread^2 / (2 sd^2))
+ *   sd    = MARGIN_SD * sqrt(total / LEAGUE_AVG_GAME_TOTAL)
+ *
+ * calibrated so a pick'em at the league-average total goes to OT
+ * OT_BASE_RATE of the time. It depends only on the game, so slates compute
+ * it once per game (games_prepare) and every player gathers it by index. */
+static double ot_probability(double spread, double game_total) {
+    double scale = game_total > 0.0 ? game_total / LEAGUE_AVG_GAME_TOTAL : 1.0;
+    double sd = MARGIN_SD * sqrt(scale);
+    double z = spread / sd;
+    return OT_BASE_RATE * (MARGIN_SD / sd) * exp(-0.5 * z * z);
+}
+
+/* Extra minutes a player gets in an OT game, relative to expected minutes.
+ * Each period can end tied again (OT_REPEAT); starters play a bigger share
+ * of OT than of regulation. Projection mixture: 1 + P(OT) * boost. */
+static inline double overtime_boost(double expected_minutes, double season_minutes) {
+    double share = expected_minutes / 48.0 * (1.0 + OT_STARTER_BOOST * starter_share(season_minutes));
+    share = clamp(share, 0.0, 1.0);
+    double ot_minutes = OT_MINUTES / (1.0 - OT_REPEAT) * share;
+    return expected_minutes > 0.0 ? ot_minutes / expected_minutes : 0.0;
+}
+
 /*======================== INPUT STRUCTS ========================*/
 
 typedef struct {
@@ -76,6 +521,38 @@ typedef struct {
     double expected_minutes;       /* expected minutes for this game */
     double matchup_pace;           /* projected pace for game (possessions per team) */
     int is_back_to_back;           /* 1 if on B2B, else 0 */
+
+    /* Minutes sub-model */
+    double recent_minutes;         /* last N games avg minutes; = season_avg_minutes if unused */
+    double spread;                 /* team point spread (negative = favored) */
+    double rest_days;              /* days since last game (0 = back-to-back) */
+    double fouls_per36;            /* personal fouls per 36 minutes */
+    double minutes_cap;            /* injury minutes restriction; 0 = none */
+    double injury_games_missed;    /* games missed injured in the last 10 */
+
+    /* Teammate absences */
+    double usage_rate;             /* baseline usage %, used to share out absent teammates' load */
+    double usage_multiplier;       /* scoring-share change from absences; 1.0 = full roster */
+    int is_out;                    /* 1 if ruled out: projects to 0 */
+
+    /* Other props (see MULTI-STAT); lines / recent default to the season avg */
+    double reb_line, reb_avg, reb_recent, opp_reb_vs_pos;
+    double ast_line, ast_avg, ast_recent, opp_ast_vs_pos;
+    double fg3_line, fg3_avg, fg3_recent, opp_fg3_vs_pos;
+
+    /* Scheduling (see DEADLINE SCHEDULER) */
+    double tipoff;                 /* scheduled tip, HHMM local (1930 = 7:30pm); NAN if unknown */
+
+    /* Market prices (see MARKET ODDS): American (-110) or decimal (1.91) */
+    double over_price, under_price;
+    double market_p_over;          /* no-vig P(over); NAN = derive from the prices */
+
+    /* Labels, present in history stores (see BACKTEST) */
+    double game_date;              /* yyyymmdd */
+    double actual_pts;             /* points scored; NAN if not yet played */
+    double closing_line;           /* closing points line; NAN if unknown (see CLOSING LINE VALUE) */
+
+    int archetype;                 /* row of WEIGHT_PROFILES; ARCH_GLOBAL if unknown */
 } Inputs;
 
 typedef struct {
@@ -88,82 +565,96 @@ typedef struct {
     double mult_minutes;
     double mult_pace;
     double mult_b2b;
+    double mult_blowout;
+    double mult_usage;
 
     double uncapped_multiplier;
     double final_multiplier;
+    double ot_probability;
+    double mult_overtime;          /* regulation/OT mixture, applied after the cap */
     double projection;
 } Output;
 
 /*======================== MODEL FUNCTIONS ========================*/
 
-static double base_points(const Inputs *in) {
-    return W_BASE_LINE * in->player_line_pts
-         + W_BASE_SEASON_AVG * in->season_avg_pts;
+static double base_points(const Inputs *in, const WeightProfile *w) {
+    return w->base_line * in->player_line_pts
+         + w->base_season_avg * in->season_avg_pts;
 }
 
-static double homeaway_multiplier(const Inputs *in) {
-    /* Simple: +W_HOME_AWAY at home, -W_HOME_AWAY away */
-    double delta = in->is_home ? +W_HOME_AWAY : -W_HOME_AWAY;
+static double homeaway_multiplier(const Inputs *in, const WeightProfile *w) {
+    /* Simple: +home_away at home, -home_away away */
+    double delta = in->is_home ? +w->home_away : -w->home_away;
     return 1.0 + delta;
 }
 
-static double game_total_multiplier(const Inputs *in) {
-    /* Normalize by league avg and weight: (OU - baseline)/baseline scaled by W_GAME_TOTAL */
+static double game_total_multiplier(const Inputs *in, const WeightProfile *w) {
+    /* Normalize by league avg and weight: (OU - baseline)/baseline scaled by game_total */
     double rel = (in->game_total_ou - LEAGUE_AVG_GAME_TOTAL) / LEAGUE_AVG_GAME_TOTAL;
-    return 1.0 + rel * W_GAME_TOTAL;
+    return 1.0 + response(FACTOR_GAME_TOTAL, rel) * w->game_total;
 }
 
-static double team_total_multiplier(const Inputs *in) {
+static double team_total_multiplier(const Inputs *in, const WeightProfile *w) {
     double rel = (in->team_total_ou - LEAGUE_AVG_TEAM_TOTAL) / LEAGUE_AVG_TEAM_TOTAL;
-    return 1.0 + rel * W_TEAM_TOTAL;
+    return 1.0 + response(FACTOR_TEAM_TOTAL, rel) * w->team_total;
 }
 
-static double defense_vs_pos_multiplier(const Inputs *in) {
+static double defense_vs_pos_multiplier(const Inputs *in, const WeightProfile *w) {
     /* If opp allows more than baseline to this position -> boost; less -> penalty */
     double rel = 0.0;
     if (LEAGUE_BASE_PTS_ALLOWED_POS > 0.0) {
         rel = (in->opp_pts_allowed_vs_pos - LEAGUE_BASE_PTS_ALLOWED_POS)
               / LEAGUE_BASE_PTS_ALLOWED_POS;
+        rel = response(FACTOR_DEF_VS_POS, rel);
     }
-    return 1.0 + rel * W_DEF_VS_POS;
+    return 1.0 + rel * w->def_vs_pos;
 }
 
-static double recent_form_multiplier(const Inputs *in) {
-    if (W_RECENT_FORM == 0.0 || in->season_avg_pts <= 0.0) return 1.0;
+static double recent_form_multiplier(const Inputs *in, const WeightProfile *w) {
+    if (w->recent_form == 0.0 || in->season_avg_pts <= 0.0) return 1.0;
     double rel = (in->recent_avg_pts - in->season_avg_pts) / in->season_avg_pts;
-    return 1.0 + rel * W_RECENT_FORM;
+    return 1.0 + response(FACTOR_RECENT_FORM, rel) * w->recent_form;
 }
 
-static double minutes_trend_multiplier(const Inputs *in) {
-    if (W_MINUTES_TREND == 0.0 || in->season_avg_minutes <= 0.0) return 1.0;
+static double minutes_trend_multiplier(const Inputs *in, const WeightProfile *w) {
+    if (w->minutes_trend == 0.0 || in->season_avg_minutes <= 0.0) return 1.0;
     double rel = (in->expected_minutes - in->season_avg_minutes) / in->season_avg_minutes;
-    return 1.0 + rel * W_MINUTES_TREND;
+    return 1.0 + response(FACTOR_MINUTES_TREND, rel) * w->minutes_trend;
 }
 
-static double pace_multiplier(const Inputs *in) {
-    if (W_PACE == 0.0 || LEAGUE_AVG_PACE <= 0.0) return 1.0;
+static double pace_multiplier(const Inputs *in, const WeightProfile *w) {
+    if (w->pace == 0.0 || LEAGUE_AVG_PACE <= 0.0) return 1.0;
     double rel = (in->matchup_pace - LEAGUE_AVG_PACE) / LEAGUE_AVG_PACE;
-    return 1.0 + rel * W_PACE;
+    return 1.0 + response(FACTOR_PACE, rel) * w->pace;
 }
 
-static double b2b_multiplier(const Inputs *in) {
-    if (!in->is_back_to_back || W_B2B_PENALTY <= 0.0) return 1.0;
+static double b2b_multiplier(const Inputs *in, const WeightProfile *w) {
+    if (!in->is_back_to_back || w->b2b_penalty <= 0.0) return 1.0;
     /* Simple fixed penalty when on a back-to-back */
-    return 1.0 - W_B2B_PENALTY;
+    return 1.0 - w->b2b_penalty;
+}
+
+static double blowout_multiplier(const Inputs *in) {
+    double minutes, rate;
+    blowout_lookup(in->spread, starter_share(in->season_avg_minutes), &minutes, &rate);
+    return 1.0 + W_BLOWOUT * (rate - 1.0);
 }
 
 static Output project(const Inputs *in) {
     Output out;
+    const WeightProfile *w = profile_for(in->archetype);
 
-    out.base_points     = base_points(in);
-    out.mult_homeaway   = homeaway_multiplier(in);
-    out.mult_game_total = game_total_multiplier(in);
-    out.mult_team_total = team_total_multiplier(in);
-    out.mult_def_pos    = defense_vs_pos_multiplier(in);
-    out.mult_recent     = recent_form_multiplier(in);
-    out.mult_minutes    = minutes_trend_multiplier(in);
-    out.mult_pace       = pace_multiplier(in);
-    out.mult_b2b        = b2b_multiplier(in);
+    out.base_points     = base_points(in, w);
+    out.mult_homeaway   = homeaway_multiplier(in, w);
+    out.mult_game_total = game_total_multiplier(in, w);
+    out.mult_team_total = team_total_multiplier(in, w);
+    out.mult_def_pos    = defense_vs_pos_multiplier(in, w);
+    out.mult_recent     = recent_form_multiplier(in, w);
+    out.mult_minutes    = minutes_trend_multiplier(in, w);
+    out.mult_pace       = pace_multiplier(in, w);
+    out.mult_b2b        = b2b_multiplier(in, w);
+    out.mult_blowout    = blowout_multiplier(in);
+    out.mult_usage      = in->usage_multiplier;
 
     out.uncapped_multiplier =
         out.mult_homeaway *
@@ -173,83 +664,6502 @@ static Output project(const Inputs *in) {
         out.mult_recent *
         out.mult_minutes *
         out.mult_pace *
-        out.mult_b2b;
+        out.mult_b2b *
+        out.mult_blowout *
+        out.mult_usage;
 
     out.final_multiplier = clamp(out.uncapped_multiplier, MULT_MIN, MULT_MAX);
-    out.projection = out.base_points * out.final_multiplier;
+    out.ot_probability = ot_probability(in->spread, in->game_total_ou);
+    out.mult_overtime = 1.0 + out.ot_probability * overtime_boost(in->expected_minutes, in->season_avg_minutes);
+    out.projection = in->is_out ? 0.0 : out.base_points * out.final_multiplier * out.mult_overtime;
     return out;
 }
 
-/*======================== DEMO / INTERACTIVE ========================*/
+/*======================== COLUMNAR BATCH ========================*/
 
-static void print_output(const Inputs *in, const Output *o) {
-    printf("\nProjection for %s\n", in->player_name);
-    printf("Base points (blend): %.2f\n", o->base_points);
-    printf("Multipliers:\n");
-    printf("  Home/Away         : %.4f\n", o->mult_homeaway);
-    printf("  Game Total (OU)   : %.4f\n", o->mult_game_total);
-    printf("  Team Total (OU)   : %.4f\n", o->mult_team_total);
-    printf("  Def vs Position   : %.4f\n", o->mult_def_pos);
-    printf("  Recent Form       : %.4f\n", o->mult_recent);
-    printf("  Minutes Trend     : %.4f\n", o->mult_minutes);
-    printf("  Pace              : %.4f\n", o->mult_pace);
-    printf("  Back-to-Back      : %.4f\n", o->mult_b2b);
-    printf("Uncapped Multiplier : %.4f\n", o->uncapped_multiplier);
-    printf("Final Multiplier    : %.4f  (capped to [%.2f, %.2f])\n", o->final_multiplier, MULT_MIN, MULT_MAX);
-    printf("Projected Points    : %.2f\n\n", o->projection);
+/* A slate stored column-wise so the batch kernel streams each field
+ * contiguously. Flags are stored as 0.0/1.0 so they can be used as lane
+ * masks; archetype is a profile-row index already validated at load time. */
+#define NAME_LEN 32
+#define TEAM_LEN 8
+
+typedef struct {
+    size_t n, cap;
+    char (*player_name)[NAME_LEN];
+    double *player_line_pts;
+    double *season_avg_pts;
+    double *is_home;
+    double *game_total_ou;
+    double *team_total_ou;
+    double *opp_pts_allowed_vs_pos;
+    double *recent_avg_pts;
+    double *season_avg_minutes;
+    double *expected_minutes;
+    double *matchup_pace;
+    double *is_back_to_back;
+    double *recent_minutes;
+    double *spread;
+    double *rest_days;
+    double *fouls_per36;
+    double *minutes_cap;
+    double *injury_games_missed;
+    double *usage_rate;
+    double *usage_multiplier;
+    double *is_out;
+    double *reb_line, *reb_avg, *reb_recent, *opp_reb_vs_pos;
+    double *ast_line, *ast_avg, *ast_recent, *opp_ast_vs_pos;
+    double *fg3_line, *fg3_avg, *fg3_recent, *opp_fg3_vs_pos;
+    double *tipoff;
+    double *over_price, *under_price, *market_p_over;
+    double *game_date;
+    double *actual_pts;
+    double *closing_line;
+    char (*team)[TEAM_LEN];
+    char (*game)[NAME_LEN];
+    unsigned char *archetype;
+
+    /* Per-game values, filled by games_prepare() */
+    int *game_idx;                 /* row -> game */
+    size_t n_games;
+    double *game_ot_prob;          /* [n_games] */
+
+    int mapped;                    /* columns point into a Snapshot, not owned */
+    size_t row_offset;             /* source row of row 0, for shard copies */
+} InputColumns;
+
+typedef struct {
+    double *base_points;
+    double *final_multiplier;
+    double *projection;
+} OutputColumns;
+
+/* Numeric columns: CSV header name, offset in Inputs, offset in InputColumns,
+ * whether the Inputs field is an int flag, and the value used when a slate
+ * file omits the column (NAN = copy from the matching season avg column,
+ * see columns_fill_defaults(); for actual_pts it stays NAN = unknown).
+ * New fields go at the end: tree dumps address features by table index. */
+typedef struct {
+    const char *csv_name;
+    size_t in_off;
+    size_t col_off;
+    int is_flag;
+    double missing;
+} FieldDesc;
+
+#define FIELD(csv, member, flag, missing) \
+    { csv, offsetof(Inputs, member), offsetof(InputColumns, member), flag, missing }
+
+static const FieldDesc INPUT_FIELDS[] = {
+    FIELD("line",        player_line_pts,        0, 0.0),
+    FIELD("season_avg",  season_avg_pts,         0, 0.0),
+    FIELD("is_home",     is_home,                1, 0.0),
+    FIELD("game_total",  game_total_ou,          0, 229.0),
+    FIELD("team_total",  team_total_ou,          0, 114.5),
+    FIELD("opp_vs_pos",  opp_pts_allowed_vs_pos, 0, 23.0),
+    FIELD("recent_avg",  recent_avg_pts,         0, NAN),
+    FIELD("season_min",  season_avg_minutes,     0, 0.0),
+    FIELD("exp_min",     expected_minutes,       0, NAN),
+    FIELD("pace",        matchup_pace,           0, 99.5),
+    FIELD("b2b",         is_back_to_back,        1, 0.0),
+    FIELD("recent_min",  recent_minutes,         0, NAN),
+    FIELD("spread",      spread,                 0, 0.0),
+    FIELD("rest_days",   rest_days,              0, 1.0),
+    FIELD("pf36",        fouls_per36,            0, 0.0),
+    FIELD("min_cap",     minutes_cap,            0, 0.0),
+    FIELD("inj_missed",  injury_games_missed,    0, 0.0),
+    FIELD("usage",       usage_rate,             0, 20.0),
+    FIELD("usage_mult",  usage_multiplier,       0, 1.0),
+    FIELD("out",         is_out,                 1, 0.0),
+    FIELD("reb_line",    reb_line,               0, NAN),
+    FIELD("reb_avg",     reb_avg,                0, 0.0),
+    FIELD("reb_recent",  reb_recent,             0, NAN),
+    FIELD("opp_reb_vs_pos", opp_reb_vs_pos,      0, 9.0),
+    FIELD("ast_line",    ast_line,               0, NAN),
+    FIELD("ast_avg",     ast_avg,                0, 0.0),
+    FIELD("ast_recent",  ast_recent,             0, NAN),
+    FIELD("opp_ast_vs_pos", opp_ast_vs_pos,      0, 5.0),
+    FIELD("fg3_line",    fg3_line,               0, NAN),
+    FIELD("fg3_avg",     fg3_avg,                0, 0.0),
+    FIELD("fg3_recent",  fg3_recent,             0, NAN),
+    FIELD("opp_fg3_vs_pos", opp_fg3_vs_pos,      0, 2.5),
+    FIELD("tip",         tipoff,                 0, NAN),
+    FIELD("date",        game_date,              0, 0.0),
+    FIELD("actual",      actual_pts,             0, NAN),
+    FIELD("over",        over_price,             0, NAN),
+    FIELD("under",       under_price,            0, NAN),
+    FIELD("mkt_p_over",  market_p_over,          0, NAN),
+    FIELD("close",       closing_line,           0, NAN),
+};
+#define N_INPUT_FIELDS (sizeof(INPUT_FIELDS) / sizeof(INPUT_FIELDS[0]))
+
+static double *column_ptr(InputColumns *c, const FieldDesc *f) {
+    return *(double **)((char *)c + f->col_off);
 }
 
-int main(void) {
-    Inputs in;
+static int columns_alloc(InputColumns *c, size_t cap) {
+    memset(c, 0, sizeof(*c));
+    c->cap = cap ? cap : 1;
+    c->player_name = calloc(c->cap, sizeof(*c->player_name));
+    c->team        = calloc(c->cap, sizeof(*c->team));
+    c->game        = calloc(c->cap, sizeof(*c->game));
+    c->archetype   = calloc(c->cap, sizeof(*c->archetype));
+    if (!c->player_name || !c->team || !c->game || !c->archetype) return -1;
+    for (size_t k = 0; k < N_INPUT_FIELDS; ++k) {
+        double **col = (double **)((char *)c + INPUT_FIELDS[k].col_off);
+        *col = calloc(c->cap, sizeof(double));
+        if (!*col) return -1;
+    }
+    return 0;
+}
 
-    /* === Prompt user for inputs from terminal === */
-    char namebuf[128];
-    printf("Player name: ");
-    if (!fgets(namebuf, sizeof(namebuf), stdin)) return 0;
-    /* strip newline */
-    for (int i = 0; namebuf[i]; ++i) { if (namebuf[i] == '\n') { namebuf[i] = 0; break; } }
-    in.player_name = namebuf;
+static void columns_free(InputColumns *c) {
+    free(c->game_idx);
+    free(c->game_ot_prob);
+    if (c->mapped) { memset(c, 0, sizeof(*c)); return; }
+    free(c->player_name);
+    free(c->team);
+    free(c->game);
+    free(c->archetype);
+    for (size_t k = 0; k < N_INPUT_FIELDS; ++k) free(column_ptr(c, &INPUT_FIELDS[k]));
+    memset(c, 0, sizeof(*c));
+}
 
-    printf("Sportsbook line (points): ");
-    scanf("%lf", &in.player_line_pts);
+static int columns_grow(InputColumns *c) {
+    size_t cap = c->cap * 2;
+    void *p;
+    if (c->mapped) return -1;
+    if (!(p = realloc(c->player_name, cap * sizeof(*c->player_name)))) return -1;
+    c->player_name = p;
+    if (!(p = realloc(c->team, cap * sizeof(*c->team)))) return -1;
+    c->team = p;
+    if (!(p = realloc(c->game, cap * sizeof(*c->game)))) return -1;
+    c->game = p;
+    if (!(p = realloc(c->archetype, cap * sizeof(*c->archetype)))) return -1;
+    c->archetype = p;
+    for (size_t k = 0; k < N_INPUT_FIELDS; ++k) {
+        double **col = (double **)((char *)c + INPUT_FIELDS[k].col_off);
+        if (!(p = realloc(*col, cap * sizeof(double)))) return -1;
+        *col = p;
+    }
+    c->cap = cap;
+    return 0;
+}
 
-    printf("Season avg points: ");
-    scanf("%lf", &in.season_avg_pts);
+/* Owned copy of rows [begin, end) of src, per-game values included */
+static int columns_copy_range(InputColumns *dst, const InputColumns *src, size_t begin, size_t end) {
+    size_t n = end - begin;
+    if (columns_alloc(dst, n) != 0) return -1;
+    dst->n = n;
+    memcpy(dst->player_name, src->player_name + begin, n * sizeof(*src->player_name));
+    memcpy(dst->team, src->team + begin, n * sizeof(*src->team));
+    memcpy(dst->game, src->game + begin, n * sizeof(*src->game));
+    memcpy(dst->archetype, src->archetype + begin, n * sizeof(*src->archetype));
+    for (size_t k = 0; k < N_INPUT_FIELDS; ++k)
+        memcpy(column_ptr(dst, &INPUT_FIELDS[k]), column_ptr((InputColumns *)src, &INPUT_FIELDS[k]) + begin,
+               n * sizeof(double));
+    dst->game_idx = malloc((n ? n : 1) * sizeof(int));
+    dst->game_ot_prob = malloc((src->n_games ? src->n_games : 1) * sizeof(double));
+    if (!dst->game_idx || !dst->game_ot_prob) return -1;
+    memcpy(dst->game_idx, src->game_idx + begin, n * sizeof(int));
+    memcpy(dst->game_ot_prob, src->game_ot_prob, src->n_games * sizeof(double));
+    dst->n_games = src->n_games;
+    dst->row_offset = src->row_offset + begin;
+    return 0;
+}
 
-    printf("Is home? (1=yes, 0=no): ");
-    scanf("%d", &in.is_home);
+static int output_columns_alloc(OutputColumns *o, size_t n) {
+    o->base_points      = calloc(n ? n : 1, sizeof(double));
+    o->final_multiplier = calloc(n ? n : 1, sizeof(double));
+    o->projection       = calloc(n ? n : 1, sizeof(double));
+    return (o->base_points && o->final_multiplier && o->projection) ? 0 : -1;
+}
 
-    printf("Game total O/U: ");
-    scanf("%lf", &in.game_total_ou);
+static void output_columns_free(OutputColumns *o) {
+    free(o->base_points);
+    free(o->final_multiplier);
+    free(o->projection);
+    memset(o, 0, sizeof(*o));
+}
 
-    printf("Team total O/U: ");
-    scanf("%lf", &in.team_total_ou);
+/* Batch version of project() over rows [begin, end); results land in out at
+ * [0, end - begin). Same math, but written without per-row branches: the
+ * weight row is gathered by archetype index (or fixed, if profile is not
+ * PROFILE_PER_ROW) and every "disabled" case folds into a zero relative
+ * deviation, so the body is straight-line arithmetic. With response curves
+ * loaded each deviation goes through its lookup table, one scalar
+ * floor/lerp each (see lut_eval).
+ * P(OT) is gathered per game (games_prepare() must have run).
+ * Results match project() row for row. */
+#define PROFILE_PER_ROW (-1)
 
-    printf("Opponent points allowed to this position (per game): ");
-    scanf("%lf", &in.opp_pts_allowed_vs_pos);
+static void project_batch(const InputColumns *c, size_t begin, size_t end, int profile,
+                          OutputColumns *out) {
+    const double *line   = c->player_line_pts;
+    const double *season = c->season_avg_pts;
+    const double *home   = c->is_home;
+    const double *gt     = c->game_total_ou;
+    const double *tt     = c->team_total_ou;
+    const double *dvp    = c->opp_pts_allowed_vs_pos;
+    const double *recent = c->recent_avg_pts;
+    const double *smin   = c->season_avg_minutes;
+    const double *emin   = c->expected_minutes;
+    const double *pace   = c->matchup_pace;
+    const double *b2b    = c->is_back_to_back;
+    const double *spread = c->spread;
+    const double *usage  = c->usage_multiplier;
+    const double *is_out = c->is_out;
+    const unsigned char *arch = c->archetype;
+    const int *game = c->game_idx;
+    const double *p_ot = c->game_ot_prob;
+    const double dvp_base  = LEAGUE_BASE_PTS_ALLOWED_POS > 0.0 ? LEAGUE_BASE_PTS_ALLOWED_POS : 1.0;
+    const double dvp_on    = LEAGUE_BASE_PTS_ALLOWED_POS > 0.0 ? 1.0 : 0.0;
+    const double pace_base = LEAGUE_AVG_PACE > 0.0 ? LEAGUE_AVG_PACE : 1.0;
+    const double pace_on   = LEAGUE_AVG_PACE > 0.0 ? 1.0 : 0.0;
+    const FactorLut *luts  = FACTOR_CURVES_ON ? FACTOR_LUTS : NULL;
+    const WeightProfile *fixed = profile == PROFILE_PER_ROW ? NULL : profile_for(profile);
 
-    /* Optional extras (enter season values again to neutralize effects) */
-    printf("Recent avg points (last N; enter season avg to ignore): ");
-    scanf("%lf", &in.recent_avg_pts);
+    for (size_t i = begin; i < end; ++i) {
+        const WeightProfile *w = fixed ? fixed : &WEIGHT_PROFILES[arch[i]];
 
-    printf("Season avg minutes: ");
-    scanf("%lf", &in.season_avg_minutes);
+        double s_ok  = season[i] > 0.0 ? 1.0 : 0.0;
+        double s_den = season[i] > 0.0 ? season[i] : 1.0;
+        double m_ok  = smin[i] > 0.0 ? 1.0 : 0.0;
+        double m_den = smin[i] > 0.0 ? smin[i] : 1.0;
 
-    printf("Expected minutes this game: ");
-    scanf("%lf", &in.expected_minutes);
+        double r_gt     = (gt[i] - LEAGUE_AVG_GAME_TOTAL) / LEAGUE_AVG_GAME_TOTAL;
+        double r_tt     = (tt[i] - LEAGUE_AVG_TEAM_TOTAL) / LEAGUE_AVG_TEAM_TOTAL;
+        double r_dvp    = dvp_on * (dvp[i] - LEAGUE_BASE_PTS_ALLOWED_POS) / dvp_base;
+        double r_recent = s_ok * (recent[i] - season[i]) / s_den;
+        double r_min    = m_ok * (emin[i] - smin[i]) / m_den;
+        double r_pace   = pace_on * (pace[i] - LEAGUE_AVG_PACE) / pace_base;
+        if (luts) {
+            r_gt     = lut_eval(&luts[FACTOR_GAME_TOTAL], r_gt);
+            r_tt     = lut_eval(&luts[FACTOR_TEAM_TOTAL], r_tt);
+            r_dvp    = dvp_on  * lut_eval(&luts[FACTOR_DEF_VS_POS], r_dvp);
+            r_recent = s_ok    * lut_eval(&luts[FACTOR_RECENT_FORM], r_recent);
+            r_min    = m_ok    * lut_eval(&luts[FACTOR_MINUTES_TREND], r_min);
+            r_pace   = pace_on * lut_eval(&luts[FACTOR_PACE], r_pace);
+        }
 
-    printf("Matchup pace (possessions per team): ");
-    scanf("%lf", &in.matchup_pace);
+        double bo_min, bo_rate;
+        blowout_lookup(spread[i], starter_share(smin[i]), &bo_min, &bo_rate);
 
-    printf("Back-to-back? (1=yes, 0=no): ");
-    scanf("%d", &in.is_back_to_back);
+        double m = (1.0 + (2.0 * home[i] - 1.0) * w->home_away)
+                 * (1.0 + r_gt * w->game_total)
+                 * (1.0 + r_tt * w->team_total)
+                 * (1.0 + r_dvp * w->def_vs_pos)
+                 * (1.0 + r_recent * w->recent_form)
+                 * (1.0 + r_min * w->minutes_trend)
+                 * (1.0 + r_pace * w->pace)
+                 * (1.0 - b2b[i] * w->b2b_penalty)
+                 * (1.0 + W_BLOWOUT * (bo_rate - 1.0))
+                 * usage[i];
 
-    /* Compute & print */
-    Output out = project(&in);
-    print_output(&in, &out);
+        double base = w->base_line * line[i] + w->base_season_avg * season[i];
+        double fm = m < MULT_MIN ? MULT_MIN : (m > MULT_MAX ? MULT_MAX : m);
+        out->base_points[i - begin]      = base;
+        out->final_multiplier[i - begin] = fm;
+        double ot = 1.0 + p_ot[game[i]] * overtime_boost(emin[i], smin[i]);
+        out->projection[i - begin]       = base * fm * ot * (1.0 - is_out[i]);
+    }
+}
 
-    /* Tip: tweak the weights/constants at the top to calibrate your model
-       to historical data or to your personal handicapping philosophy. */
+/*======================== NAME INDEX ========================*/
+
+/* Open-addressing string -> int map (FNV-1a, linear probing) for looking
+ * players, games and books up by name in O(1) on streaming paths. Keys are
+ * copied, truncated to NAME_LEN - 1. */
+typedef struct {
+    size_t cap, n;             /* cap is a power of two */
+    char (*key)[NAME_LEN];
+    int *value;                /* -1 = empty slot */
+} NameIndex;
+
+static uint64_t name_hash(const char *s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t k = 0; s[k] && k < NAME_LEN - 1; ++k) {
+        h ^= (unsigned char)s[k];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static int name_index_init(NameIndex *ix, size_t expected) {
+    ix->cap = 16;
+    while (ix->cap < expected * 2) ix->cap *= 2;
+    ix->n = 0;
+    ix->key = calloc(ix->cap, sizeof(*ix->key));
+    ix->value = malloc(ix->cap * sizeof(int));
+    if (!ix->key || !ix->value) return -1;
+    for (size_t k = 0; k < ix->cap; ++k) ix->value[k] = -1;
+    return 0;
+}
+
+static void name_index_free(NameIndex *ix) {
+    free(ix->key);
+    free(ix->value);
+    memset(ix, 0, sizeof(*ix));
+}
+
+static int name_index_find(const NameIndex *ix, const char *name) {
+    size_t mask = ix->cap - 1;
+    for (size_t k = name_hash(name) & mask;; k = (k + 1) & mask) {
+        if (ix->value[k] < 0) return -1;
+        if (strncmp(ix->key[k], name, NAME_LEN - 1) == 0) return ix->value[k];
+    }
+}
+
+static int name_index_put(NameIndex *ix, const char *name, int value) {
+    if ((ix->n + 1) * 10 > ix->cap * 7) {
+        NameIndex bigger;
+        if (name_index_init(&bigger, ix->cap) != 0) return -1;
+        for (size_t k = 0; k < ix->cap; ++k)
+            if (ix->value[k] >= 0) name_index_put(&bigger, ix->key[k], ix->value[k]);
+        name_index_free(ix);
+        *ix = bigger;
+    }
+    size_t mask = ix->cap - 1;
+    size_t k = name_hash(name) & mask;
+    while (ix->value[k] >= 0 && strncmp(ix->key[k], name, NAME_LEN - 1) != 0) k = (k + 1) & mask;
+    if (ix->value[k] < 0) ix->n++;
+    snprintf(ix->key[k], NAME_LEN, "%s", name);
+    ix->value[k] = value;
+    return 0;
+}
+
+/*======================== MINUTES MODEL ========================*/
+
+/* Derives expected_minutes for rows [begin, end) before projection:
+ *
+ *   rotation = W_MIN_RECENT * recent_min + (1 - W_MIN_RECENT) * season_min
+ *   minutes  = rotation * blowout * rest * fouls * injury, capped by min_cap
+ *
+ * The blowout term is the expected minutes factor over the spread's margin
+ * distribution (see BLOWOUT FACTOR): starters lose minutes as blowouts get
+ * likelier, the bench gains them. Same columnar, branch-free shape as
+ * project_batch(), so a league-wide refresh is one streaming pass. */
+static void minutes_batch(InputColumns *c, size_t begin, size_t end) {
+    const double *smin   = c->season_avg_minutes;
+    const double *rmin   = c->recent_minutes;
+    const double *spread = c->spread;
+    const double *rest   = c->rest_days;
+    const double *pf36   = c->fouls_per36;
+    const double *cap    = c->minutes_cap;
+    const double *inj    = c->injury_games_missed;
+    double *emin = c->expected_minutes;
+
+    for (size_t i = begin; i < end; ++i) {
+        double rotation = W_MIN_RECENT * rmin[i] + (1.0 - W_MIN_RECENT) * smin[i];
+
+        double blowout, rate;
+        blowout_lookup(spread[i], starter_share(smin[i]), &blowout, &rate);
+
+        double restf = 1.0 - (rest[i] < 0.5 ? MIN_REST_B2B : 0.0)
+                           + (rest[i] >= 1.5 ? MIN_REST_EXTRA : 0.0);
+
+        double extra_fouls = pf36[i] - MIN_FOUL_BASE;
+        double fouls  = 1.0 - MIN_FOUL_SLOPE * (extra_fouls > 0.0 ? extra_fouls : 0.0);
+        double injury = 1.0 - MIN_INJURY_SLOPE * inj[i];
+
+        double m = rotation * blowout * restf * fouls * injury;
+        double limit = cap[i] > 0.0 ? cap[i] : 48.0;
+        emin[i] = clamp(m, 0.0, limit);
+    }
+}
+
+/*======================== MARKET ODDS ========================*/
+
+/* Over / under prices -> the market's no-vig P(over). A price is American
+ * when |x| >= 100 (-110, +135), otherwise decimal (1.91). The raw implied
+ * probabilities q = 1 / decimal sum to Q = 1 + vig; the methods differ in
+ * how they take the vig back out:
+ *
+ *   mult    p = q / Q
+ *   power   p = q^k, k solving q_o^k + q_u^k = 1 (more vig off longshots)
+ *   shin    p = (sqrt(z^2 + 4 (1-z) q^2 / Q) - z) / (2 (1-z)), z solving
+ *           sum p = 1 (z = share of informed money, Shin 1993)
+ *
+ * power and shin take a fixed number of Newton steps from k = 1 / z = 0
+ * with no data-dependent branches, so the row loops vectorize. Rows
+ * missing a price come out NAN. Loaders fill mkt_p_over in bulk with the
+ * --devig method wherever the slate did not supply it. */
+typedef enum { DEVIG_MULT, DEVIG_POWER, DEVIG_SHIN, N_DEVIG_METHODS } DevigMethod;
+
+static const char *const DEVIG_NAMES[N_DEVIG_METHODS] = { "mult", "power", "shin" };
+static DevigMethod DEVIG_METHOD = DEVIG_SHIN;
+#define DEVIG_NEWTON_STEPS 6
+
+static inline double price_decimal(double price) {
+    double american = price >= 0.0 ? 1.0 + price / 100.0 : 1.0 - 100.0 / price;
+    return fabs(price) >= 100.0 ? american : price;
+}
+
+/* out[i] = no-vig P(over) for rows [0, n) */
+static void devig_batch(const double *over, const double *under, size_t n, DevigMethod m, double *out) {
+    switch (m) {
+    case DEVIG_MULT:
+        for (size_t i = 0; i < n; ++i) {
+            double qo = 1.0 / price_decimal(over[i]), qu = 1.0 / price_decimal(under[i]);
+            out[i] = qo / (qo + qu);
+        }
+        break;
+    case DEVIG_POWER:
+        for (size_t i = 0; i < n; ++i) {
+            double lo = -log(price_decimal(over[i])), lu = -log(price_decimal(under[i]));
+            double k = 1.0;
+            for (int s = 0; s < DEVIG_NEWTON_STEPS; ++s) {
+                double a = exp(k * lo), b = exp(k * lu);
+                k -= (a + b - 1.0) / (a * lo + b * lu);
+            }
+            out[i] = exp(k * lo);
+        }
+        break;
+    case DEVIG_SHIN:
+        for (size_t i = 0; i < n; ++i) {
+            double qo = 1.0 / price_decimal(over[i]), qu = 1.0 / price_decimal(under[i]);
+            double Q = qo + qu, co = 4.0 * qo * qo / Q, cu = 4.0 * qu * qu / Q;
+            double z = 0.0;
+            for (int s = 0; s < DEVIG_NEWTON_STEPS; ++s) {
+                double ra = sqrt(z * z + co * (1.0 - z)), rb = sqrt(z * z + cu * (1.0 - z));
+                double g = ra + rb - 2.0;
+                double dg = (2.0 * z - co) / (2.0 * ra) + (2.0 * z - cu) / (2.0 * rb);
+                z -= g / dg;
+            }
+            out[i] = (sqrt(z * z + co * (1.0 - z)) - z) / (2.0 * (1.0 - z));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* Fill mkt_p_over for rows [begin, end) where it is unset */
+static void market_prepare(InputColumns *c, size_t begin, size_t end) {
+    double p[256];
+    for (size_t b = begin; b < end; b += 256) {
+        size_t n = end - b < 256 ? end - b : 256;
+        devig_batch(c->over_price + b, c->under_price + b, n, DEVIG_METHOD, p);
+        for (size_t i = 0; i < n; ++i)
+            c->market_p_over[b + i] = isnan(c->market_p_over[b + i]) ? p[i] : c->market_p_over[b + i];
+    }
+}
+
+/*======================== NUMA SHARDS ========================*/
+
+/* Multi-threaded slate runs laid out by NUMA node. The slate is cut
+ * into one contiguous row range per node, sized by the node's share of the
+ * threads, and each range into one shard per thread. A thread pins itself
+ * to its node's CPUs before it allocates and fills its shard's input and
+ * output columns, so first-touch places those pages on the local node and
+ * the hot loops never read remote memory; only the final copy-back of
+ * results crosses nodes. Topology comes from sysfs (no libnuma); without
+ * it everything runs as node 0. Shard copies keep their source row in
+ * row_offset, so keyed work (the sim's random streams) matches a
+ * single-threaded run exactly. */
+#define NUMA_MAX_NODES 64
+
+typedef struct {
+    int n_nodes;
+    int node_id[NUMA_MAX_NODES];
+    int n_cpus[NUMA_MAX_NODES];
+    cpu_set_t cpus[NUMA_MAX_NODES];
+} NumaTopology;
+
+/* Parse a sysfs cpulist ("0-3,8-11") into set */
+static void cpulist_parse(const char *s, cpu_set_t *set) {
+    CPU_ZERO(set);
+    while (*s) {
+        char *e;
+        long lo = strtol(s, &e, 10), hi = lo;
+        if (e == s) break;
+        if (*e == '-') hi = strtol(e + 1, &e, 10);
+        for (long k = lo; k <= hi && k < CPU_SETSIZE; ++k) CPU_SET((int)k, set);
+        s = *e == ',' ? e + 1 : e;
+        if (*s == '\n') break;
+    }
+}
+
+/* Nodes with at least one CPU this process may run on */
+static void numa_discover(NumaTopology *t) {
+    cpu_set_t allowed;
+    memset(t, 0, sizeof(*t));
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        CPU_ZERO(&allowed);
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long k = 0; k < n && k < CPU_SETSIZE; ++k) CPU_SET((int)k, &allowed);
+    }
+    for (int node = 0; node < 1024 && t->n_nodes < NUMA_MAX_NODES; ++node) {
+        char path[64], buf[1024];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *fp = fopen(path, "r");
+        if (!fp) continue;
+        int ok = fgets(buf, sizeof(buf), fp) != NULL;
+        fclose(fp);
+        if (!ok) continue;
+        cpu_set_t *set = &t->cpus[t->n_nodes];
+        cpulist_parse(buf, set);
+        CPU_AND(set, set, &allowed);
+        if (CPU_COUNT(set) == 0) continue;
+        t->node_id[t->n_nodes] = node;
+        t->n_cpus[t->n_nodes] = CPU_COUNT(set);
+        t->n_nodes++;
+    }
+    if (t->n_nodes == 0) {
+        t->n_nodes = 1;
+        t->cpus[0] = allowed;
+        t->n_cpus[0] = CPU_COUNT(&allowed) > 0 ? CPU_COUNT(&allowed) : 1;
+    }
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Per-shard work: local holds the shard's rows (local row r = source row
+ * src_begin + r) in node-local memory; results go back through ctx. */
+typedef int (*ShardFn)(const InputColumns *local, size_t src_begin, void *ctx);
+
+typedef struct {
+    const cpu_set_t *cpus;
+    const InputColumns *src;
+    size_t begin, end;
+    ShardFn fn;
+    void *ctx;
+    int failed;
+    double seconds;                /* time in fn, excluding the shard copy */
+} NumaShard;
 
+static void *numa_shard_run(void *arg) {
+    NumaShard *s = arg;
+    InputColumns local;
+
+    pthread_setaffinity_np(pthread_self(), sizeof(*s->cpus), s->cpus);
+    if (columns_copy_range(&local, s->src, s->begin, s->end) != 0) {
+        s->failed = 1;
+    } else {
+        double t0 = now_seconds();
+        s->failed = s->fn(&local, s->begin, s->ctx) != 0;
+        s->seconds = now_seconds() - t0;
+    }
+    columns_free(&local);
+    return NULL;
+}
+
+/* Run fn over every row of c on n_threads pinned threads (0 = one per
+ * allowed CPU), reporting per-node throughput on stderr. */
+static int numa_run(const InputColumns *c, int n_threads, ShardFn fn, void *ctx) {
+    NumaTopology t;
+    numa_discover(&t);
+    int total_cpus = 0;
+    for (int k = 0; k < t.n_nodes; ++k) total_cpus += t.n_cpus[k];
+    if (n_threads <= 0) n_threads = total_cpus;
+
+    /* Threads per node in proportion to its CPUs (largest remainder) */
+    int per_node[NUMA_MAX_NODES], assigned = 0;
+    for (int k = 0; k < t.n_nodes; ++k) {
+        per_node[k] = n_threads * t.n_cpus[k] / total_cpus;
+        assigned += per_node[k];
+    }
+    for (int k = 0; assigned < n_threads; k = (k + 1) % t.n_nodes, ++assigned) per_node[k]++;
+
+    NumaShard *shards = calloc((size_t)n_threads, sizeof(*shards));
+    pthread_t *tid = calloc((size_t)n_threads, sizeof(*tid));
+    if (!shards || !tid) { free(shards); free(tid); return -1; }
+
+    int s = 0;
+    size_t row = 0;
+    for (int k = 0; k < t.n_nodes; ++k) {
+        if (per_node[k] == 0) continue;
+        size_t node_end = row + (c->n - row) * (size_t)per_node[k] / (size_t)(n_threads - s);
+        size_t node_begin = row;
+        for (int j = 0; j < per_node[k]; ++j, ++s) {
+            NumaShard *sh = &shards[s];
+            sh->cpus = &t.cpus[k];
+            sh->src = c;
+            sh->begin = row;
+            sh->end = node_begin + (node_end - node_begin) * (size_t)(j + 1) / (size_t)per_node[k];
+            sh->fn = fn;
+            sh->ctx = ctx;
+            row = sh->end;
+        }
+    }
+
+    int started = 0, rc = 0;
+    for (; started < n_threads; ++started)
+        if (pthread_create(&tid[started], NULL, numa_shard_run, &shards[started]) != 0) { rc = -1; break; }
+    for (int k = 0; k < started; ++k) pthread_join(tid[k], NULL);
+
+    s = 0;
+    for (int k = 0; k < t.n_nodes; ++k) {
+        size_t rows = 0;
+        double secs = 0.0;
+        for (int j = 0; j < per_node[k]; ++j, ++s) {
+            if (s >= started || shards[s].failed) rc = -1;
+            rows += shards[s].end - shards[s].begin;
+            if (shards[s].seconds > secs) secs = shards[s].seconds;
+        }
+        if (per_node[k] == 0) continue;
+        fprintf(stderr, "node %d: %d threads, %zu rows in %.3f ms (%.0f rows/s)\n", t.node_id[k],
+                per_node[k], rows, secs * 1e3, secs > 0.0 ? rows / secs : 0.0);
+    }
+    free(shards);
+    free(tid);
+    return rc;
+}
+
+/*======================== SLATE FILES ========================*/
+
+/* Slate CSV: a header row naming columns, then one player per row.
+ *   name,line,season_avg,is_home,game_total,team_total,opp_vs_pos,
+ *   recent_avg,season_min,exp_min,pace,b2b,archetype,
+ *   recent_min,spread,rest_days,pf36,min_cap,inj_missed,
+ *   team,usage,usage_mult,out,
+ *   {reb,ast,fg3}_{line,avg,recent}, opp_{reb,ast,fg3}_vs_pos, game,
+ *   tip, date, actual
+ * Only name/line/season_avg are required; missing columns get a neutral
+ * value and unknown columns are ignored. No quoting. */
+#define CSV_MAX_COLS 64
+
+/* Group rows by the game column and compute per-game values once. Rows
+ * with no game id are treated as their own game. Call again after editing
+ * spread or game_total. */
+static int games_prepare(InputColumns *c) {
+    NameIndex ix;
+    free(c->game_idx);
+    free(c->game_ot_prob);
+    c->n_games = 0;
+    c->game_idx = malloc((c->n ? c->n : 1) * sizeof(int));
+    c->game_ot_prob = malloc((c->n ? c->n : 1) * sizeof(double));
+    if (!c->game_idx || !c->game_ot_prob || name_index_init(&ix, c->n) != 0) return -1;
+
+    for (size_t i = 0; i < c->n; ++i) {
+        int g = c->game[i][0] ? name_index_find(&ix, c->game[i]) : -1;
+        if (g < 0) {
+            g = (int)c->n_games++;
+            if (c->game[i][0] && name_index_put(&ix, c->game[i], g) != 0) { name_index_free(&ix); return -1; }
+            c->game_ot_prob[g] = ot_probability(c->spread[i], c->game_total_ou[i]);
+        }
+        c->game_idx[i] = g;
+    }
+    name_index_free(&ix);
     return 0;
 }
+
+/* Fill the NAN "copy from the season avg" defaults for row i */
+static void columns_fill_defaults(InputColumns *c, size_t i) {
+    if (isnan(c->recent_avg_pts[i])) c->recent_avg_pts[i] = c->season_avg_pts[i];
+    if (isnan(c->recent_minutes[i])) c->recent_minutes[i] = c->season_avg_minutes[i];
+    if (isnan(c->expected_minutes[i])) c->expected_minutes[i] = c->season_avg_minutes[i];
+    double *stat_avg[]  = { c->reb_avg, c->ast_avg, c->fg3_avg };
+    double *stat_line[] = { c->reb_line, c->ast_line, c->fg3_line };
+    double *stat_rec[]  = { c->reb_recent, c->ast_recent, c->fg3_recent };
+    for (int s = 0; s < 3; ++s) {
+        if (isnan(stat_line[s][i])) stat_line[s][i] = stat_avg[s][i];
+        if (isnan(stat_rec[s][i]))  stat_rec[s][i]  = stat_avg[s][i];
+    }
+}
+
+/* Row i's source column col is about to change from old: values that
+ * columns_fill_defaults() copied from it still equal old, so unset them
+ * to be refilled from the new value (an explicit value that happens to
+ * equal its source follows it too; the store does not record which). */
+static void columns_unset_defaults(InputColumns *c, size_t i, const double *col, double old) {
+    double *dep[2] = { NULL, NULL };
+    if (col == c->season_avg_pts)          { dep[0] = c->recent_avg_pts; }
+    else if (col == c->season_avg_minutes) { dep[0] = c->recent_minutes; dep[1] = c->expected_minutes; }
+    else if (col == c->reb_avg)            { dep[0] = c->reb_line; dep[1] = c->reb_recent; }
+    else if (col == c->ast_avg)            { dep[0] = c->ast_line; dep[1] = c->ast_recent; }
+    else if (col == c->fg3_avg)            { dep[0] = c->fg3_line; dep[1] = c->fg3_recent; }
+    for (int k = 0; k < 2; ++k)
+        if (dep[k] && dep[k][i] == old) dep[k][i] = NAN;
+}
+
+static int csv_split(char *line, char **fields, int max) {
+    int n = 0;
+    char *p = line;
+    for (;;) {
+        if (n < max) fields[n++] = p;
+        char *comma = strchr(p, ',');
+        if (!comma) break;
+        *comma = 0;
+        p = comma + 1;
+    }
+    for (int k = 0; k < n; ++k) {
+        char *f = fields[k];
+        while (*f == ' ' || *f == '\t') ++f;
+        char *e = f + strlen(f);
+        while (e > f && (e[-1] == '\n' || e[-1] == '\r' || e[-1] == ' ' || e[-1] == '\t')) *--e = 0;
+        fields[k] = f;
+    }
+    return n;
+}
+
+typedef struct {
+    int ncols;
+    int map[CSV_MAX_COLS];     /* csv column -> INPUT_FIELDS index, -1 ignored */
+    int name_col, arch_col, team_col, game_col;
+} SlateHeader;
+
+static int slate_header_parse(char *line, SlateHeader *h, const char *path) {
+    char *fields[CSV_MAX_COLS];
+    h->name_col = h->arch_col = h->team_col = h->game_col = -1;
+    h->ncols = csv_split(line, fields, CSV_MAX_COLS);
+    for (int k = 0; k < h->ncols; ++k) {
+        h->map[k] = -1;
+        if (strcmp(fields[k], "name") == 0)      { h->name_col = k; continue; }
+        if (strcmp(fields[k], "archetype") == 0) { h->arch_col = k; continue; }
+        if (strcmp(fields[k], "team") == 0)      { h->team_col = k; continue; }
+        if (strcmp(fields[k], "game") == 0)      { h->game_col = k; continue; }
+        for (size_t f = 0; f < N_INPUT_FIELDS; ++f)
+            if (strcmp(fields[k], INPUT_FIELDS[f].csv_name) == 0) h->map[k] = (int)f;
+    }
+    if (h->name_col < 0) { fprintf(stderr, "%s: missing 'name' column\n", path); return -1; }
+    return 0;
+}
+
+/* Parse one data line (modified in place) into row i of c */
+static void slate_parse_row(InputColumns *c, size_t i, char *line, const SlateHeader *h) {
+    char *fields[CSV_MAX_COLS];
+    int nf = csv_split(line, fields, CSV_MAX_COLS);
+
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f)
+        column_ptr(c, &INPUT_FIELDS[f])[i] = INPUT_FIELDS[f].missing;
+    snprintf(c->player_name[i], NAME_LEN, "%s", h->name_col < nf ? fields[h->name_col] : "");
+    snprintf(c->team[i], TEAM_LEN, "%s", h->team_col >= 0 && h->team_col < nf ? fields[h->team_col] : "");
+    snprintf(c->game[i], NAME_LEN, "%s", h->game_col >= 0 && h->game_col < nf ? fields[h->game_col] : "");
+    c->archetype[i] = (unsigned char)archetype_from_name(h->arch_col >= 0 && h->arch_col < nf ? fields[h->arch_col] : NULL);
+
+    for (int k = 0; k < nf && k < h->ncols; ++k) {
+        if (h->map[k] < 0 || !fields[k][0]) continue;
+        const FieldDesc *f = &INPUT_FIELDS[h->map[k]];
+        double v = strtod(fields[k], NULL);
+        column_ptr(c, f)[i] = f->is_flag ? (v != 0.0) : v;
+    }
+    columns_fill_defaults(c, i);
+}
+
+static int slate_load_csv(const char *path, InputColumns *c) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) { perror(path); return -1; }
+
+    char line[1024];
+    SlateHeader h;
+    if (!fgets(line, sizeof(line), fp)) { fclose(fp); fprintf(stderr, "%s: empty file\n", path); return -1; }
+    if (slate_header_parse(line, &h, path) != 0) { fclose(fp); return -1; }
+
+    if (columns_alloc(c, 256) != 0) { fclose(fp); return -1; }
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '\n' || line[0] == '#') continue;
+        if (c->n == c->cap && columns_grow(c) != 0) { fclose(fp); return -1; }
+        slate_parse_row(c, c->n++, line, &h);
+    }
+    fclose(fp);
+    market_prepare(c, 0, c->n);
+    return games_prepare(c);
+}
+
+/*======================== SNAPSHOT FILES ========================*/
+
+/* Binary columnar slate/history store, designed to be mmapped:
+ *
+ *   SnapHeader | SnapColumn[n_cols] | column data (each 64-byte aligned)
+ *
+ * Columns are found by name, so files written before a field existed still
+ * open (the missing column gets its slate default). Numeric columns are
+ * f64, strings are fixed-width, archetype is u8. Mappings are private and
+ * writable (copy-on-write), so stages like the minutes model can update a
+ * mapped slate in place without touching the file. Extra f64 columns (e.g.
+ * staged outputs, see PRECOMPUTE) can be stored alongside the inputs; the
+ * header records which model and sim settings produced them, and for a
+ * compacted store the input-log position it reflects. Files are written
+ * to a temporary name and renamed into place, so readers never
+ * see a partial store. */
+#define SNAP_MAGIC   "NBASNAP"
+#define SNAP_VERSION 3
+#define SNAP_ALIGN   64
+
+enum { SNAP_F64 = 1, SNAP_STR = 2, SNAP_U8 = 3 };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_cols;
+    uint64_t n_rows;
+    uint64_t model_tag;            /* model_fingerprint() of staged outputs; 0 = none */
+    uint64_t sim_seed;
+    uint32_t sim_n;                /* sims behind staged sim_* columns; 0 = none */
+    uint32_t reserved;
+    uint64_t wal_seq;              /* last input-log event folded in (see INPUT LOG); 0 = none */
+} SnapHeader;
+
+typedef struct {
+    char name[24];
+    uint32_t kind;
+    uint32_t elem_size;
+    uint64_t offset;               /* from start of file */
+} SnapColumn;
+
+typedef struct {
+    const char *name;
+    const double *data;            /* [n_rows], in slate row order */
+} SnapExtra;
+
+typedef struct {
+    uint64_t model_tag;
+    uint64_t sim_seed;
+    uint32_t sim_n;
+    uint64_t wal_seq;
+} SnapMeta;
+
+typedef struct {
+    void *base;
+    size_t len;
+    const SnapHeader *hdr;
+    const SnapColumn *dir;
+    void **heap;                   /* defaults allocated for missing columns */
+    int n_heap;
+} Snapshot;
+
+static int snap_write_column(FILE *fp, SnapColumn *dir, int *k, uint64_t *off, const char *name,
+                             uint32_t kind, uint32_t elem, const void *data, const size_t *perm, size_t n) {
+    SnapColumn *d = &dir[(*k)++];
+    memset(d, 0, sizeof(*d));
+    snprintf(d->name, sizeof(d->name), "%s", name);
+    d->kind = kind;
+    d->elem_size = elem;
+    *off = (*off + SNAP_ALIGN - 1) / SNAP_ALIGN * SNAP_ALIGN;
+    d->offset = *off;
+    if (fseek(fp, (long)d->offset, SEEK_SET) != 0) return -1;
+    for (size_t r = 0; r < n; ++r) {
+        size_t src = perm ? perm[r] : r;
+        if (fwrite((const char *)data + src * elem, elem, 1, fp) != 1) return -1;
+    }
+    *off += (uint64_t)elem * n;
+    return 0;
+}
+
+/* Write c (rows reordered by perm if not NULL) plus extra f64 columns. */
+static int snapshot_write(const char *path, const InputColumns *c, const size_t *perm,
+                          const SnapExtra *extra, int n_extra, const SnapMeta *meta) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) { perror(tmp); return -1; }
+
+    uint32_t n_cols = (uint32_t)(N_INPUT_FIELDS + 4 + (size_t)n_extra);
+    SnapColumn *dir = calloc(n_cols, sizeof(*dir));
+    if (!dir) { fclose(fp); return -1; }
+    uint64_t off = sizeof(SnapHeader) + (uint64_t)n_cols * sizeof(SnapColumn);
+    int k = 0, rc = 0;
+
+    rc |= snap_write_column(fp, dir, &k, &off, "name", SNAP_STR, NAME_LEN, c->player_name, perm, c->n);
+    rc |= snap_write_column(fp, dir, &k, &off, "team", SNAP_STR, TEAM_LEN, c->team, perm, c->n);
+    rc |= snap_write_column(fp, dir, &k, &off, "game", SNAP_STR, NAME_LEN, c->game, perm, c->n);
+    rc |= snap_write_column(fp, dir, &k, &off, "archetype", SNAP_U8, 1, c->archetype, perm, c->n);
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f)
+        rc |= snap_write_column(fp, dir, &k, &off, INPUT_FIELDS[f].csv_name, SNAP_F64, sizeof(double),
+                                column_ptr((InputColumns *)c, &INPUT_FIELDS[f]), perm, c->n);
+    for (int e = 0; e < n_extra; ++e)
+        rc |= snap_write_column(fp, dir, &k, &off, extra[e].name, SNAP_F64, sizeof(double),
+                                extra[e].data, perm, c->n);
+
+    SnapHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAP_MAGIC, sizeof(SNAP_MAGIC));
+    h.version = SNAP_VERSION;
+    h.n_cols = n_cols;
+    h.n_rows = c->n;
+    if (meta) {
+        h.model_tag = meta->model_tag;
+        h.sim_seed = meta->sim_seed;
+        h.sim_n = meta->sim_n;
+        h.wal_seq = meta->wal_seq;
+    }
+    if (rc == 0 && (fseek(fp, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, fp) != 1 ||
+                    fwrite(dir, sizeof(*dir), n_cols, fp) != n_cols)) rc = -1;
+    free(dir);
+    if (fclose(fp) != 0) rc = -1;
+    if (rc == 0 && rename(tmp, path) != 0) { perror(path); rc = -1; }
+    if (rc != 0) {
+        fprintf(stderr, "%s: write failed\n", path);
+        unlink(tmp);
+    }
+    return rc;
+}
+
+static void snapshot_close(Snapshot *s) {
+    for (int k = 0; k < s->n_heap; ++k) free(s->heap[k]);
+    free(s->heap);
+    if (s->base) munmap(s->base, s->len);
+    memset(s, 0, sizeof(*s));
+}
+
+static int snapshot_open(const char *path, Snapshot *s) {
+    memset(s, 0, sizeof(*s));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { perror(path); return -1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapHeader)) {
+        fprintf(stderr, "%s: not a snapshot\n", path);
+        close(fd);
+        return -1;
+    }
+    s->len = (size_t)st.st_size;
+    s->base = mmap(NULL, s->len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (s->base == MAP_FAILED) { s->base = NULL; perror(path); return -1; }
+
+    s->hdr = s->base;
+    s->dir = (const SnapColumn *)(s->hdr + 1);
+    if (memcmp(s->hdr->magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) != 0 || s->hdr->version != SNAP_VERSION ||
+        sizeof(SnapHeader) + (size_t)s->hdr->n_cols * sizeof(SnapColumn) > s->len) {
+        fprintf(stderr, "%s: bad snapshot header\n", path);
+        snapshot_close(s);
+        return -1;
+    }
+    for (uint32_t k = 0; k < s->hdr->n_cols; ++k) {
+        const SnapColumn *d = &s->dir[k];
+        if (d->offset % SNAP_ALIGN || d->offset + (uint64_t)d->elem_size * s->hdr->n_rows > s->len) {
+            fprintf(stderr, "%s: column '%.24s' out of bounds\n", path, d->name);
+            snapshot_close(s);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Column data by name, or NULL if absent / of another shape */
+static void *snapshot_column(const Snapshot *s, const char *name, uint32_t kind, uint32_t elem) {
+    for (uint32_t k = 0; k < s->hdr->n_cols; ++k) {
+        const SnapColumn *d = &s->dir[k];
+        if (strncmp(d->name, name, sizeof(d->name)) == 0 && d->kind == kind && d->elem_size == elem)
+            return (char *)s->base + d->offset;
+    }
+    return NULL;
+}
+
+static void *snapshot_default(Snapshot *s, size_t bytes) {
+    void **nh = realloc(s->heap, (size_t)(s->n_heap + 1) * sizeof(*nh));
+    if (!nh) return NULL;
+    s->heap = nh;
+    void *p = calloc(bytes ? bytes : 1, 1);
+    if (p) s->heap[s->n_heap++] = p;
+    return p;
+}
+
+/* Point c's columns into the mapping. c does not own them (c->mapped), so
+ * columns_free(c) must run before snapshot_close(s). */
+static int snapshot_columns(Snapshot *s, InputColumns *c) {
+    size_t n = (size_t)s->hdr->n_rows;
+    memset(c, 0, sizeof(*c));
+    c->n = c->cap = n;
+    c->mapped = 1;
+
+    c->player_name = snapshot_column(s, "name", SNAP_STR, NAME_LEN);
+    c->team = snapshot_column(s, "team", SNAP_STR, TEAM_LEN);
+    c->game = snapshot_column(s, "game", SNAP_STR, NAME_LEN);
+    c->archetype = snapshot_column(s, "archetype", SNAP_U8, 1);
+    if (!c->player_name && !(c->player_name = snapshot_default(s, n * NAME_LEN))) return -1;
+    if (!c->team && !(c->team = snapshot_default(s, n * TEAM_LEN))) return -1;
+    if (!c->game && !(c->game = snapshot_default(s, n * NAME_LEN))) return -1;
+    if (!c->archetype && !(c->archetype = snapshot_default(s, n))) return -1;
+    for (size_t i = 0; i < n; ++i)
+        if (c->archetype[i] >= N_ARCHETYPES) c->archetype[i] = ARCH_GLOBAL;
+
+    int defaulted = 0;
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f) {
+        const FieldDesc *fd = &INPUT_FIELDS[f];
+        double **col = (double **)((char *)c + fd->col_off);
+        *col = snapshot_column(s, fd->csv_name, SNAP_F64, sizeof(double));
+        if (*col) continue;
+        if (!(*col = snapshot_default(s, n * sizeof(double)))) return -1;
+        for (size_t i = 0; i < n; ++i) (*col)[i] = fd->missing;
+        defaulted = 1;
+    }
+    if (defaulted) {
+        for (size_t i = 0; i < n; ++i) columns_fill_defaults(c, i);
+        market_prepare(c, 0, n);
+    }
+    return games_prepare(c);
+}
+
+/* Load a slate from either a CSV file or a snapshot store (by magic).
+ * For a CSV, s is left empty; either way close with columns_free(c) and
+ * then snapshot_close(s). */
+static int slate_open(const char *path, InputColumns *c, Snapshot *s) {
+    char magic[8] = { 0 };
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { perror(path); return -1; }
+    size_t got = fread(magic, 1, sizeof(magic), fp);
+    fclose(fp);
+    memset(s, 0, sizeof(*s));
+    if (got < sizeof(magic) || memcmp(magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) != 0) return slate_load_csv(path, c);
+    if (snapshot_open(path, s) != 0) return -1;
+    if (snapshot_columns(s, c) != 0) { columns_free(c); snapshot_close(s); return -1; }
+    return 0;
+}
+
+/* Identifies everything the projection depends on besides the inputs:
+ * weight profiles, response curves and the blowout table. */
+static uint64_t model_fingerprint(void) {
+    const void *parts[] = { WEIGHT_PROFILES, FACTOR_LUTS, &FACTOR_CURVES_ON, &BLOWOUT };
+    const size_t sizes[] = { sizeof(WEIGHT_PROFILES), sizeof(FACTOR_LUTS), sizeof(FACTOR_CURVES_ON), sizeof(BLOWOUT) };
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t p = 0; p < sizeof(parts) / sizeof(parts[0]); ++p)
+        for (size_t k = 0; k < sizes[p]; ++k) {
+            h ^= ((const unsigned char *)parts[p])[k];
+            h *= 1099511628211ULL;
+        }
+    return h | 1;                  /* never 0, which means "nothing staged" */
+}
+
+/* Staged outputs: out_base, out_mult, out_proj, and SimResult fields */
+static const char *const STAGED_SIM_COLUMNS[] = { "sim_mean", "sim_p_over", "sim_p10", "sim_p50", "sim_p90" };
+#define N_STAGED_SIM_COLUMNS (sizeof(STAGED_SIM_COLUMNS) / sizeof(STAGED_SIM_COLUMNS[0]))
+
+/* A staged output column, if s holds one made by the current model */
+static const double *snapshot_staged(const Snapshot *s, const char *name) {
+    if (!s->base || s->hdr->model_tag != model_fingerprint()) return NULL;
+    return snapshot_column(s, name, SNAP_F64, sizeof(double));
+}
+
+static int date_row_cmp(const void *a, const void *b) {
+    const double *x = a, *y = b;   /* { date, row } */
+    if (x[0] != y[0]) return x[0] < y[0] ? -1 : 1;
+    return x[1] < y[1] ? -1 : x[1] > y[1];
+}
+
+/* Row order for a store: by date, ties kept in input order */
+static size_t *date_order(const InputColumns *c) {
+    double (*key)[2] = malloc((c->n ? c->n : 1) * sizeof(*key));
+    size_t *perm = malloc((c->n ? c->n : 1) * sizeof(size_t));
+    if (!key || !perm) { free(key); free(perm); return NULL; }
+    for (size_t i = 0; i < c->n; ++i) {
+        key[i][0] = c->game_date[i];
+        key[i][1] = (double)i;
+    }
+    qsort(key, c->n, sizeof(*key), date_row_cmp);
+    for (size_t i = 0; i < c->n; ++i) perm[i] = (size_t)key[i][1];
+    free(key);
+    return perm;
+}
+
+static int cmd_snapshot(int argc, char **argv) {
+    if (argc < 2) { fprintf(stderr, "usage: points_model snapshot <slate.csv> <out.snap>\n"); return 2; }
+
+    InputColumns c;
+    if (slate_load_csv(argv[0], &c) != 0) return 1;
+    /* Stores are kept in date order so date ranges are contiguous row ranges */
+    size_t *perm = date_order(&c);
+    if (!perm) { columns_free(&c); return 1; }
+    int rc = snapshot_write(argv[1], &c, perm, NULL, 0, NULL);
+    if (rc == 0) fprintf(stderr, "wrote %zu rows to %s\n", c.n, argv[1]);
+    free(perm);
+    columns_free(&c);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== BATCH PROJECTION ========================*/
+
+static int batch_shard(const InputColumns *local, size_t src_begin, void *ctx) {
+    OutputColumns *out = ctx, o;
+    if (output_columns_alloc(&o, local->n) != 0) { output_columns_free(&o); return -1; }
+    project_batch(local, 0, local->n, PROFILE_PER_ROW, &o);
+    memcpy(out->base_points + src_begin, o.base_points, local->n * sizeof(double));
+    memcpy(out->final_multiplier + src_begin, o.final_multiplier, local->n * sizeof(double));
+    memcpy(out->projection + src_begin, o.projection, local->n * sizeof(double));
+    output_columns_free(&o);
+    return 0;
+}
+
+static int cmd_batch(int argc, char **argv) {
+    int derive_minutes = 0, n_threads = -1;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--minutes") == 0) {
+            derive_minutes = 1;
+            --argc;
+            ++argv;
+        } else if (strcmp(argv[0], "--threads") == 0 && argc >= 2) {
+            n_threads = atoi(argv[1]);
+            argc -= 2;
+            argv += 2;
+        } else {
+            break;
+        }
+    }
+    if (argc < 1) { fprintf(stderr, "usage: points_model batch [--minutes] [--threads N] <slate.csv|.snap>\n"); return 2; }
+
+    InputColumns c;
+    OutputColumns o;
+    Snapshot snap;
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    if (output_columns_alloc(&o, c.n) != 0) { columns_free(&c); snapshot_close(&snap); return 1; }
+
+    /* A precomputed store made by this model starts hot */
+    const double *warm_base = derive_minutes ? NULL : snapshot_staged(&snap, "out_base");
+    const double *warm_mult = derive_minutes ? NULL : snapshot_staged(&snap, "out_mult");
+    const double *warm_proj = derive_minutes ? NULL : snapshot_staged(&snap, "out_proj");
+    int warm = warm_base && warm_mult && warm_proj;
+
+    double t0 = now_seconds();
+    if (derive_minutes) minutes_batch(&c, 0, c.n);
+    double t1 = now_seconds();
+    if (warm) {
+        memcpy(o.base_points, warm_base, c.n * sizeof(double));
+        memcpy(o.final_multiplier, warm_mult, c.n * sizeof(double));
+        memcpy(o.projection, warm_proj, c.n * sizeof(double));
+    } else if (n_threads < 0) {
+        project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+    } else if (numa_run(&c, n_threads, batch_shard, &o) != 0) {
+        output_columns_free(&o);
+        columns_free(&c);
+        snapshot_close(&snap);
+        return 1;
+    }
+    double t2 = now_seconds();
+
+    printf("%-24s %-12s %8s %8s %8s %8s\n", "player", "profile", "minutes", "base", "mult", "proj");
+    for (size_t i = 0; i < c.n; ++i)
+        printf("%-24s %-12s %8.1f %8.2f %8.4f %8.2f\n", c.player_name[i],
+               ARCHETYPE_SCALES[c.archetype[i]].name, c.expected_minutes[i],
+               o.base_points[i], o.final_multiplier[i], o.projection[i]);
+    if (derive_minutes) fprintf(stderr, "derived minutes for %zu players in %.3f ms\n", c.n, (t1 - t0) * 1e3);
+    fprintf(stderr, "%s %zu players in %.3f ms\n", warm ? "loaded staged projections for" : "projected",
+            c.n, (t2 - t1) * 1e3);
+
+    output_columns_free(&o);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return 0;
+}
+
+/*======================== MULTI-STAT ========================*/
+
+/* The same blend-and-multiplier model for every prop we price. Each stat has
+ * its own line / season avg / recent avg / DvP columns, league DvP baseline
+ * and a row of STAT_SCALES that rescales the (archetype) weights per factor.
+ * Context deviations (totals, pace, minutes, B2B, blowout, usage) are shared
+ * and computed once per row; the per-stat part runs as fixed-width lanes
+ * over N_STATS so one pass over a row yields every stat, and combos are
+ * sums of the stat projections. Row STAT_PTS reproduces project_batch(). */
+typedef enum { STAT_PTS = 0, STAT_REB, STAT_AST, STAT_FG3, N_STATS } Stat;
+typedef enum { COMBO_PRA = N_STATS, COMBO_PR, COMBO_PA, COMBO_RA, N_STAT_OUTPUTS } StatCombo;
+
+static const char *const STAT_OUTPUT_NAMES[N_STAT_OUTPUTS] = {
+    "pts", "reb", "ast", "fg3", "pra", "pr", "pa", "ra",
+};
+
+typedef struct {
+    double league_allowed_pos;     /* DvP baseline for this stat */
+    double home_away, game_total, team_total, def_vs_pos;
+    double recent_form, minutes_trend, pace, b2b_penalty;
+    double blowout, usage;
+} StatScale;
+
+static const StatScale STAT_SCALES[N_STATS] = {
+    /*           dvp base  home  game  team  dvp   recent mins  pace  b2b   blow  usage */
+    [STAT_PTS] = { 23.0,   1.00, 1.00, 1.00, 1.00, 1.00,  1.00, 1.00, 1.00, 1.00, 1.00 },
+    [STAT_REB] = {  9.0,   0.50, 0.40, 0.20, 1.00, 1.00,  1.10, 1.00, 1.00, 0.80, 0.30 },
+    [STAT_AST] = {  5.0,   0.70, 0.80, 1.10, 1.00, 1.00,  1.00, 1.00, 0.80, 0.90, 0.70 },
+    [STAT_FG3] = {  2.5,   0.80, 1.20, 1.00, 1.00, 1.30,  1.00, 0.90, 1.20, 1.00, 0.90 },
+};
+
+typedef struct {
+    double *proj[N_STAT_OUTPUTS];
+} StatOutputColumns;
+
+static int stat_output_columns_alloc(StatOutputColumns *o, size_t n) {
+    int rc = 0;
+    for (int s = 0; s < N_STAT_OUTPUTS; ++s)
+        if (!(o->proj[s] = calloc(n ? n : 1, sizeof(double)))) rc = -1;
+    return rc;
+}
+
+static void stat_output_columns_free(StatOutputColumns *o) {
+    for (int s = 0; s < N_STAT_OUTPUTS; ++s) free(o->proj[s]);
+    memset(o, 0, sizeof(*o));
+}
+
+/* Rows [begin, end) into out at [0, end - begin) */
+static void project_stats_batch(const InputColumns *c, size_t begin, size_t end, StatOutputColumns *out) {
+    const double *line[N_STATS]   = { c->player_line_pts, c->reb_line, c->ast_line, c->fg3_line };
+    const double *avg[N_STATS]    = { c->season_avg_pts, c->reb_avg, c->ast_avg, c->fg3_avg };
+    const double *recent[N_STATS] = { c->recent_avg_pts, c->reb_recent, c->ast_recent, c->fg3_recent };
+    const double *dvp[N_STATS]    = { c->opp_pts_allowed_vs_pos, c->opp_reb_vs_pos, c->opp_ast_vs_pos, c->opp_fg3_vs_pos };
+    const FactorLut *luts = FACTOR_CURVES_ON ? FACTOR_LUTS : NULL;
+    const double pace_base = LEAGUE_AVG_PACE > 0.0 ? LEAGUE_AVG_PACE : 1.0;
+    const double pace_on   = LEAGUE_AVG_PACE > 0.0 ? 1.0 : 0.0;
+
+    /* Per-lane constants, hoisted so the stat loop is straight-line SIMD */
+    double k_home[N_STATS], k_gt[N_STATS], k_tt[N_STATS], k_dvp[N_STATS], k_recent[N_STATS];
+    double k_min[N_STATS], k_pace[N_STATS], k_b2b[N_STATS], k_blow[N_STATS], k_usage[N_STATS];
+    double dvp_base[N_STATS];
+    for (int s = 0; s < N_STATS; ++s) {
+        const StatScale *k = &STAT_SCALES[s];
+        k_home[s] = k->home_away;   k_gt[s] = k->game_total;      k_tt[s] = k->team_total;
+        k_dvp[s] = k->def_vs_pos;   k_recent[s] = k->recent_form; k_min[s] = k->minutes_trend;
+        k_pace[s] = k->pace;        k_b2b[s] = k->b2b_penalty;    k_blow[s] = k->blowout;
+        k_usage[s] = k->usage;      dvp_base[s] = k->league_allowed_pos;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        const WeightProfile *w = &WEIGHT_PROFILES[c->archetype[i]];
+        double smin = c->season_avg_minutes[i];
+        double m_ok  = smin > 0.0 ? 1.0 : 0.0;
+        double m_den = smin > 0.0 ? smin : 1.0;
+
+        /* Shared context, once per row */
+        double hs     = 2.0 * c->is_home[i] - 1.0;
+        double r_gt   = (c->game_total_ou[i] - LEAGUE_AVG_GAME_TOTAL) / LEAGUE_AVG_GAME_TOTAL;
+        double r_tt   = (c->team_total_ou[i] - LEAGUE_AVG_TEAM_TOTAL) / LEAGUE_AVG_TEAM_TOTAL;
+        double r_min  = m_ok * (c->expected_minutes[i] - smin) / m_den;
+        double r_pace = pace_on * (c->matchup_pace[i] - LEAGUE_AVG_PACE) / pace_base;
+        if (luts) {
+            r_gt   = lut_eval(&luts[FACTOR_GAME_TOTAL], r_gt);
+            r_tt   = lut_eval(&luts[FACTOR_TEAM_TOTAL], r_tt);
+            r_min  = m_ok * lut_eval(&luts[FACTOR_MINUTES_TREND], r_min);
+            r_pace = pace_on * lut_eval(&luts[FACTOR_PACE], r_pace);
+        }
+        double bo_min, bo_rate;
+        blowout_lookup(c->spread[i], starter_share(smin), &bo_min, &bo_rate);
+        double b2b = c->is_back_to_back[i];
+        double usage = c->usage_multiplier[i];
+        double active = (1.0 - c->is_out[i])
+                      * (1.0 + c->game_ot_prob[c->game_idx[i]] * overtime_boost(c->expected_minutes[i], smin));
+
+        double proj[N_STATS];
+        for (int s = 0; s < N_STATS; ++s) {
+            double a = avg[s][i];
+            double s_ok  = a > 0.0 ? 1.0 : 0.0;
+            double s_den = a > 0.0 ? a : 1.0;
+            double r_dvp = (dvp[s][i] - dvp_base[s]) / dvp_base[s];
+            double r_recent = s_ok * (recent[s][i] - a) / s_den;
+            if (luts) {
+                r_dvp    = lut_eval(&luts[FACTOR_DEF_VS_POS], r_dvp);
+                r_recent = s_ok * lut_eval(&luts[FACTOR_RECENT_FORM], r_recent);
+            }
+
+            double m = (1.0 + hs * w->home_away * k_home[s])
+                     * (1.0 + r_gt * w->game_total * k_gt[s])
+                     * (1.0 + r_tt * w->team_total * k_tt[s])
+                     * (1.0 + r_dvp * w->def_vs_pos * k_dvp[s])
+                     * (1.0 + r_recent * w->recent_form * k_recent[s])
+                     * (1.0 + r_min * w->minutes_trend * k_min[s])
+                     * (1.0 + r_pace * w->pace * k_pace[s])
+                     * (1.0 - b2b * w->b2b_penalty * k_b2b[s])
+                     * (1.0 + W_BLOWOUT * k_blow[s] * (bo_rate - 1.0))
+                     * (1.0 + k_usage[s] * (usage - 1.0));
+
+            double base = w->base_line * line[s][i] + w->base_season_avg * a;
+            double fm = m < MULT_MIN ? MULT_MIN : (m > MULT_MAX ? MULT_MAX : m);
+            proj[s] = base * fm * active;
+        }
+
+        size_t o = i - begin;
+        for (int s = 0; s < N_STATS; ++s) out->proj[s][o] = proj[s];
+        out->proj[COMBO_PRA][o] = proj[STAT_PTS] + proj[STAT_REB] + proj[STAT_AST];
+        out->proj[COMBO_PR][o]  = proj[STAT_PTS] + proj[STAT_REB];
+        out->proj[COMBO_PA][o]  = proj[STAT_PTS] + proj[STAT_AST];
+        out->proj[COMBO_RA][o]  = proj[STAT_REB] + proj[STAT_AST];
+    }
+}
+
+static int cmd_stats(int argc, char **argv) {
+    int derive_minutes = 0;
+    if (argc >= 1 && strcmp(argv[0], "--minutes") == 0) { derive_minutes = 1; --argc; ++argv; }
+    if (argc < 1) { fprintf(stderr, "usage: points_model stats [--minutes] <slate.csv>\n"); return 2; }
+
+    InputColumns c;
+    StatOutputColumns o;
+    if (slate_load_csv(argv[0], &c) != 0) return 1;
+    if (stat_output_columns_alloc(&o, c.n) != 0) { stat_output_columns_free(&o); columns_free(&c); return 1; }
+
+    double t0 = now_seconds();
+    if (derive_minutes) minutes_batch(&c, 0, c.n);
+    project_stats_batch(&c, 0, c.n, &o);
+    double t1 = now_seconds();
+
+    printf("%-24s", "player");
+    for (int s = 0; s < N_STAT_OUTPUTS; ++s) printf(" %7s", STAT_OUTPUT_NAMES[s]);
+    printf("\n");
+    for (size_t i = 0; i < c.n; ++i) {
+        printf("%-24s", c.player_name[i]);
+        for (int s = 0; s < N_STAT_OUTPUTS; ++s) printf(" %7.2f", o.proj[s][i]);
+        printf("\n");
+    }
+    fprintf(stderr, "projected %d stats for %zu players in %.3f ms\n", N_STAT_OUTPUTS, c.n, (t1 - t0) * 1e3);
+
+    stat_output_columns_free(&o);
+    columns_free(&c);
+    return 0;
+}
+
+/*======================== SIMULATION ========================*/
+
+/* Monte Carlo distribution of each player's points. In each simulated night
+ * every game goes to OT with its P(OT), drawn once per (game, sim) from a
+ * stateless hash of the game id so all players in a game see the same OT
+ * outcome however the slate is split into batches or shards; each
+ * player's points are then drawn from an overdispersed normal (variance
+ * SIM_DISPERSION x mean, floored at 0) around their regulation or OT mean.
+ * The regulation mean is backed out of the mixture projection, so the
+ * simulated mean tracks project_batch(). Quantiles come from a fixed
+ * half-point histogram, so a player costs O(n_sims) with no sorting. */
+#define SIM_HIST_BINS 161          /* 0 .. 80 points by 0.5 */
+
+typedef struct {
+    double mean;
+    double p_over;                 /* P(points > line) */
+    double p10, p50, p90;
+} SimResult;
+
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* splitmix64 stream */
+static inline double rng_uniform(uint64_t *state) {
+    *state += 0x9e3779b97f4a7c15ULL;
+    return (double)(mix64(*state) >> 11) * 0x1.0p-53;
+}
+
+static inline double rng_normal(uint64_t *state) {
+    double u1 = rng_uniform(state), u2 = rng_uniform(state);
+    return sqrt(-2.0 * log(u1 > 0.0 ? u1 : 0x1.0p-53)) * cos(2.0 * M_PI * u2);
+}
+
+/* P(points > line) for row i in closed form: the limit of simulate_batch's
+ * p_over as n_sims grows (the same OT mixture of two normals). */
+static double model_p_over(const InputColumns *c, size_t i, double projection, double line) {
+    double p_ot = c->game_ot_prob[c->game_idx[i]];
+    double boost = overtime_boost(c->expected_minutes[i], c->season_avg_minutes[i]);
+    double mu_reg = projection / (1.0 + p_ot * boost), mu_ot = mu_reg * (1.0 + boost);
+    double sd_reg = sqrt(SIM_DISPERSION * mu_reg), sd_ot = sqrt(SIM_DISPERSION * mu_ot);
+    if (!(sd_reg > 0.0)) return line < 0.0 ? 1.0 : 0.0;
+    return (1.0 - p_ot) * 0.5 * erfc((line - mu_reg) / (sd_reg * M_SQRT2)) +
+           p_ot * 0.5 * erfc((line - mu_ot) / (sd_ot * M_SQRT2));
+}
+
+static double hist_quantile(const unsigned *hist, int n, double q) {
+    double target = q * n, acc = 0.0;
+    for (int b = 0; b < SIM_HIST_BINS; ++b) {
+        acc += hist[b];
+        if (acc >= target) return 0.5 * b;
+    }
+    return 0.5 * (SIM_HIST_BINS - 1);
+}
+
+/* Simulate rows [begin, end). projection[] and out[] are indexed from
+ * begin (element 0 = row begin). */
+static void simulate_batch(const InputColumns *c, const double *projection, size_t begin, size_t end,
+                           int n_sims, uint64_t seed, SimResult *out) {
+    unsigned hist[SIM_HIST_BINS];
+
+    for (size_t i = begin; i < end; ++i) {
+        double p_ot = c->game_ot_prob[c->game_idx[i]];
+        double boost = overtime_boost(c->expected_minutes[i], c->season_avg_minutes[i]);
+        double mu_reg = projection[i - begin] / (1.0 + p_ot * boost);
+        double mu_ot = mu_reg * (1.0 + boost);
+        double line = c->player_line_pts[i];
+        uint64_t row_key = mix64((uint64_t)(c->row_offset + i) * 0x9e3779b97f4a7c15ULL + 7);
+        uint64_t game_key = seed ^ (c->game[i][0] ? mix64(name_hash(c->game[i])) : row_key);
+        uint64_t state = seed ^ row_key;
+
+        memset(hist, 0, sizeof(hist));
+        double sum = 0.0;
+        int over = 0;
+        for (int k = 0; k < n_sims; ++k) {
+            double u_ot = (double)(mix64(game_key + (uint64_t)k) >> 11) * 0x1.0p-53;
+            double mu = u_ot < p_ot ? mu_ot : mu_reg;
+            double x = mu + sqrt(SIM_DISPERSION * mu) * rng_normal(&state);
+            x = x > 0.0 ? x : 0.0;
+            sum += x;
+            over += x > line;
+            int b = (int)(2.0 * x + 0.5);
+            hist[b < SIM_HIST_BINS ? b : SIM_HIST_BINS - 1]++;
+        }
+
+        SimResult *r = &out[i - begin];
+        r->mean = n_sims > 0 ? sum / n_sims : 0.0;
+        r->p_over = n_sims > 0 ? (double)over / n_sims : 0.0;
+        r->p10 = hist_quantile(hist, n_sims, 0.10);
+        r->p50 = hist_quantile(hist, n_sims, 0.50);
+        r->p90 = hist_quantile(hist, n_sims, 0.90);
+    }
+}
+
+typedef struct {
+    int n_sims;
+    uint64_t seed;
+    OutputColumns *out;
+    SimResult *sim;
+} SimShard;
+
+static int sim_shard(const InputColumns *local, size_t src_begin, void *ctx) {
+    SimShard *s = ctx;
+    OutputColumns o;
+    if (output_columns_alloc(&o, local->n) != 0) { output_columns_free(&o); return -1; }
+    SimResult *sim = calloc(local->n ? local->n : 1, sizeof(*sim));
+    if (!sim) { output_columns_free(&o); return -1; }
+    project_batch(local, 0, local->n, PROFILE_PER_ROW, &o);
+    simulate_batch(local, o.projection, 0, local->n, s->n_sims, s->seed, sim);
+    memcpy(s->out->base_points + src_begin, o.base_points, local->n * sizeof(double));
+    memcpy(s->out->final_multiplier + src_begin, o.final_multiplier, local->n * sizeof(double));
+    memcpy(s->out->projection + src_begin, o.projection, local->n * sizeof(double));
+    memcpy(s->sim + src_begin, sim, local->n * sizeof(*sim));
+    free(sim);
+    output_columns_free(&o);
+    return 0;
+}
+
+static int cmd_sim(int argc, char **argv) {
+    int n_sims = 10000, n_threads = -1;
+    uint64_t seed = 1;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--n") == 0)            n_sims = atoi(argv[1]);
+        else if (strcmp(argv[0], "--seed") == 0)    seed = strtoull(argv[1], NULL, 10);
+        else if (strcmp(argv[0], "--threads") == 0) n_threads = atoi(argv[1]);
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1 || n_sims <= 0) {
+        fprintf(stderr, "usage: points_model sim [--n sims] [--seed s] [--threads N] <slate.csv|.snap>\n");
+        return 2;
+    }
+
+    InputColumns c;
+    OutputColumns o;
+    Snapshot snap;
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    SimResult *sim = calloc(c.n ? c.n : 1, sizeof(*sim));
+    if (!sim || output_columns_alloc(&o, c.n) != 0) { free(sim); columns_free(&c); snapshot_close(&snap); return 1; }
+
+    /* Staged sims are reused only if they came from the same n and seed */
+    const double *warm_proj = snapshot_staged(&snap, "out_proj");
+    const double *warm[N_STAGED_SIM_COLUMNS];
+    int n_warm = 0;
+    if (warm_proj && snap.hdr->sim_n == (uint32_t)n_sims && snap.hdr->sim_seed == seed)
+        for (; n_warm < (int)N_STAGED_SIM_COLUMNS && (warm[n_warm] = snapshot_staged(&snap, STAGED_SIM_COLUMNS[n_warm])); ++n_warm) {}
+
+    double t0 = now_seconds();
+    if (n_warm == (int)N_STAGED_SIM_COLUMNS) {
+        memcpy(o.projection, warm_proj, c.n * sizeof(double));
+        for (size_t i = 0; i < c.n; ++i)
+            sim[i] = (SimResult){ warm[0][i], warm[1][i], warm[2][i], warm[3][i], warm[4][i] };
+    } else if (n_threads < 0) {
+        project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+        t0 = now_seconds();
+        simulate_batch(&c, o.projection, 0, c.n, n_sims, seed, sim);
+    } else if (numa_run(&c, n_threads, sim_shard, &(SimShard){ n_sims, seed, &o, sim }) != 0) {
+        free(sim);
+        output_columns_free(&o);
+        columns_free(&c);
+        snapshot_close(&snap);
+        return 1;
+    }
+    double t1 = now_seconds();
+
+    printf("%-24s %6s %7s %6s %7s %7s %6s %6s %6s\n",
+           "player", "line", "proj", "p_ot", "mean", "p_over", "p10", "p50", "p90");
+    for (size_t i = 0; i < c.n; ++i)
+        printf("%-24s %6.1f %7.2f %6.3f %7.2f %7.3f %6.1f %6.1f %6.1f\n", c.player_name[i],
+               c.player_line_pts[i], o.projection[i], c.game_ot_prob[c.game_idx[i]],
+               sim[i].mean, sim[i].p_over, sim[i].p10, sim[i].p50, sim[i].p90);
+    fprintf(stderr, "%s %zu players x %d in %.3f ms\n", n_warm == (int)N_STAGED_SIM_COLUMNS ? "loaded staged sims for" : "simulated",
+            c.n, n_sims, (t1 - t0) * 1e3);
+
+    free(sim);
+    output_columns_free(&o);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return 0;
+}
+
+/*======================== PIPELINE ========================*/
+
+/* Streaming slate run as a chain of stages joined by bounded queues:
+ *
+ *   parse -> features -> project -> simulate -> format -> write
+ *
+ * The file is read in chunks of rows and every stage works on a different
+ * chunk at the same time, so wall time tends to the slowest stage instead
+ * of the sum. Stages that keep no state across chunks run --threads
+ * threads each; parse and write are single-threaded, and write restores
+ * file order by chunk sequence number. All chunk memory is a fixed pool
+ * of --depth chunks allocated up front: parse blocks until write recycles
+ * one, which is the backpressure that keeps memory flat for any file
+ * size. Output matches batch / sim on the same file. */
+#define PIPE_CHUNK 4096
+#define PIPE_DEPTH 16
+#define PIPE_LINE  192             /* formatted bytes per row, upper bound */
+
+typedef struct {
+    size_t seq;
+    int failed;
+    InputColumns cols;
+    OutputColumns out;
+    SimResult *sim;
+    char *text;
+    size_t text_len;
+} PipeChunk;
+
+typedef struct {
+    PipeChunk **ring;
+    size_t cap, head, count;
+    int closed;
+    pthread_mutex_t mu;
+    pthread_cond_t not_empty, not_full;
+} PipeQueue;
+
+static int pipe_queue_init(PipeQueue *q, size_t cap) {
+    memset(q, 0, sizeof(*q));
+    q->cap = cap;
+    q->ring = calloc(cap, sizeof(*q->ring));
+    pthread_mutex_init(&q->mu, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    return q->ring ? 0 : -1;
+}
+
+static void pipe_queue_free(PipeQueue *q) {
+    free(q->ring);
+    pthread_mutex_destroy(&q->mu);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+}
+
+static void pipe_queue_push(PipeQueue *q, PipeChunk *ch) {
+    pthread_mutex_lock(&q->mu);
+    while (q->count == q->cap) pthread_cond_wait(&q->not_full, &q->mu);
+    q->ring[(q->head + q->count++) % q->cap] = ch;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->mu);
+}
+
+/* Next chunk, or NULL once the queue is closed and drained */
+static PipeChunk *pipe_queue_pop(PipeQueue *q) {
+    pthread_mutex_lock(&q->mu);
+    while (q->count == 0 && !q->closed) pthread_cond_wait(&q->not_empty, &q->mu);
+    PipeChunk *ch = NULL;
+    if (q->count > 0) {
+        ch = q->ring[q->head];
+        q->head = (q->head + 1) % q->cap;
+        q->count--;
+        pthread_cond_signal(&q->not_full);
+    }
+    pthread_mutex_unlock(&q->mu);
+    return ch;
+}
+
+static void pipe_queue_close(PipeQueue *q) {
+    pthread_mutex_lock(&q->mu);
+    q->closed = 1;
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_mutex_unlock(&q->mu);
+}
+
+typedef enum {
+    PIPE_PARSE, PIPE_FEATURES, PIPE_PROJECT, PIPE_SIMULATE, PIPE_FORMAT, PIPE_WRITE,
+    N_PIPE_STAGES
+} PipeStageId;
+
+typedef struct {
+    FILE *in, *out;
+    SlateHeader hdr;
+    int derive_minutes, n_sims;
+    uint64_t seed;
+    int depth;
+
+    PipeQueue q[N_PIPE_STAGES];    /* q[s] feeds stage s; q[PIPE_PARSE] is the free pool */
+    int running[N_PIPE_STAGES];    /* live threads; the last one out closes q[s + 1] */
+    double busy[N_PIPE_STAGES];    /* thread-seconds spent in the stage function */
+    pthread_mutex_t mu;
+    int failed;
+
+    size_t parse_seq, rows;        /* parse stage only */
+    size_t write_seq;              /* write stage only */
+    PipeChunk **held;              /* [depth] chunks waiting for their turn to be written */
+} Pipeline;
+
+/* Stage functions return 0 to pass the chunk on, <0 on failure, and >0
+ * (parse) at end of input or (write) when the chunk has been recycled. */
+static int pipe_parse(Pipeline *p, PipeChunk *ch) {
+    char line[1024];
+    InputColumns *c = &ch->cols;
+    c->n = 0;
+    c->row_offset = p->rows;
+    ch->seq = p->parse_seq;
+    ch->failed = 0;
+    while (c->n < c->cap && fgets(line, sizeof(line), p->in)) {
+        if (line[0] == '\n' || line[0] == '#') continue;
+        slate_parse_row(c, c->n++, line, &p->hdr);
+    }
+    if (c->n == 0) return 1;
+    p->parse_seq++;
+    p->rows += c->n;
+    return 0;
+}
+
+static int pipe_features(Pipeline *p, PipeChunk *ch) {
+    market_prepare(&ch->cols, 0, ch->cols.n);
+    if (games_prepare(&ch->cols) != 0) return -1;
+    if (p->derive_minutes) minutes_batch(&ch->cols, 0, ch->cols.n);
+    return 0;
+}
+
+static int pipe_project(Pipeline *p, PipeChunk *ch) {
+    (void)p;
+    project_batch(&ch->cols, 0, ch->cols.n, PROFILE_PER_ROW, &ch->out);
+    return 0;
+}
+
+static int pipe_simulate(Pipeline *p, PipeChunk *ch) {
+    if (p->n_sims > 0) simulate_batch(&ch->cols, ch->out.projection, 0, ch->cols.n, p->n_sims, p->seed, ch->sim);
+    return 0;
+}
+
+static int pipe_format(Pipeline *p, PipeChunk *ch) {
+    const InputColumns *c = &ch->cols;
+    size_t cap = c->cap * PIPE_LINE, len = 0;
+    for (size_t i = 0; i < c->n && len < cap; ++i) {
+        len += (size_t)snprintf(ch->text + len, cap - len, "%-24s %-12s %8.1f %8.2f %8.4f %8.2f",
+                                c->player_name[i], ARCHETYPE_SCALES[c->archetype[i]].name, c->expected_minutes[i],
+                                ch->out.base_points[i], ch->out.final_multiplier[i], ch->out.projection[i]);
+        if (p->n_sims > 0 && len < cap)
+            len += (size_t)snprintf(ch->text + len, cap - len, " %7.2f %7.3f %6.1f %6.1f %6.1f",
+                                    ch->sim[i].mean, ch->sim[i].p_over, ch->sim[i].p10, ch->sim[i].p50, ch->sim[i].p90);
+        if (len < cap) ch->text[len++] = '\n';
+    }
+    ch->text_len = len < cap ? len : cap;
+    return 0;
+}
+
+static int pipe_write(Pipeline *p, PipeChunk *ch) {
+    p->held[ch->seq % (size_t)p->depth] = ch;
+    PipeChunk *next;
+    while ((next = p->held[p->write_seq % (size_t)p->depth]) && next->seq == p->write_seq) {
+        p->held[p->write_seq % (size_t)p->depth] = NULL;
+        if (!next->failed && fwrite(next->text, 1, next->text_len, p->out) != next->text_len) {
+            pthread_mutex_lock(&p->mu);
+            p->failed = 1;
+            pthread_mutex_unlock(&p->mu);
+        }
+        p->write_seq++;
+        pipe_queue_push(&p->q[PIPE_PARSE], next);
+    }
+    return 1;
+}
+
+typedef struct {
+    const char *name;
+    int (*fn)(Pipeline *p, PipeChunk *ch);
+    int parallel;                  /* keeps no cross-chunk state, may run several threads */
+} PipeStage;
+
+static const PipeStage PIPE_STAGES[N_PIPE_STAGES] = {
+    [PIPE_PARSE]    = { "parse",    pipe_parse,    0 },
+    [PIPE_FEATURES] = { "features", pipe_features, 1 },
+    [PIPE_PROJECT]  = { "project",  pipe_project,  1 },
+    [PIPE_SIMULATE] = { "simulate", pipe_simulate, 1 },
+    [PIPE_FORMAT]   = { "format",   pipe_format,   1 },
+    [PIPE_WRITE]    = { "write",    pipe_write,    0 },
+};
+
+typedef struct {
+    Pipeline *p;
+    int stage;
+} PipeWorker;
+
+static void *pipe_worker(void *arg) {
+    Pipeline *p = ((PipeWorker *)arg)->p;
+    int s = ((PipeWorker *)arg)->stage;
+    double busy = 0.0;
+    PipeChunk *ch;
+
+    while ((ch = pipe_queue_pop(&p->q[s]))) {
+        double t0 = now_seconds();
+        int skip = ch->failed && s != PIPE_PARSE && s != PIPE_WRITE;
+        int rc = skip ? 0 : PIPE_STAGES[s].fn(p, ch);
+        busy += now_seconds() - t0;
+        if (rc < 0) {
+            ch->failed = 1;
+            pthread_mutex_lock(&p->mu);
+            p->failed = 1;
+            pthread_mutex_unlock(&p->mu);
+        }
+        if (rc > 0) {
+            if (s == PIPE_PARSE) { pipe_queue_push(&p->q[PIPE_PARSE], ch); break; }
+            continue;
+        }
+        pipe_queue_push(&p->q[s + 1], ch);
+    }
+
+    pthread_mutex_lock(&p->mu);
+    p->busy[s] += busy;
+    int last = --p->running[s] == 0;
+    pthread_mutex_unlock(&p->mu);
+    if (last && s + 1 < N_PIPE_STAGES) pipe_queue_close(&p->q[s + 1]);
+    return NULL;
+}
+
+static int cmd_pipeline(int argc, char **argv) {
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    int n_threads = 2, chunk = PIPE_CHUNK;
+    p.depth = PIPE_DEPTH;
+    p.seed = 1;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--minutes") == 0) { p.derive_minutes = 1; --argc; ++argv; continue; }
+        if (argc < 2) break;
+        if (strcmp(argv[0], "--n") == 0)             p.n_sims = atoi(argv[1]);
+        else if (strcmp(argv[0], "--seed") == 0)     p.seed = strtoull(argv[1], NULL, 10);
+        else if (strcmp(argv[0], "--threads") == 0)  n_threads = atoi(argv[1]);
+        else if (strcmp(argv[0], "--chunk") == 0)    chunk = atoi(argv[1]);
+        else if (strcmp(argv[0], "--depth") == 0)    p.depth = atoi(argv[1]);
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1 || n_threads < 1 || chunk < 1 || p.depth < 2 || p.n_sims < 0) {
+        fprintf(stderr, "usage: points_model pipeline [--minutes] [--n sims] [--seed s] [--threads N] "
+                        "[--chunk rows] [--depth chunks] <slate.csv> [out]\n");
+        return 2;
+    }
+
+    char line[1024];
+    if (!(p.in = fopen(argv[0], "r"))) { perror(argv[0]); return 1; }
+    if (!fgets(line, sizeof(line), p.in) || slate_header_parse(line, &p.hdr, argv[0]) != 0) {
+        fclose(p.in);
+        return 1;
+    }
+    p.out = argc >= 2 ? fopen(argv[1], "w") : stdout;
+    if (!p.out) { perror(argv[1]); fclose(p.in); return 1; }
+
+    /* The chunk pool: the only per-row memory the run ever holds */
+    PipeChunk *chunks = calloc((size_t)p.depth, sizeof(*chunks));
+    p.held = calloc((size_t)p.depth, sizeof(*p.held));
+    int rc = chunks && p.held ? 0 : -1;
+    pthread_mutex_init(&p.mu, NULL);
+    for (int s = 0; s < N_PIPE_STAGES; ++s)
+        if (pipe_queue_init(&p.q[s], (size_t)p.depth) != 0) rc = -1;
+    for (int k = 0; rc == 0 && k < p.depth; ++k) {
+        PipeChunk *ch = &chunks[k];
+        if (columns_alloc(&ch->cols, (size_t)chunk) != 0 || output_columns_alloc(&ch->out, (size_t)chunk) != 0 ||
+            !(ch->sim = calloc((size_t)chunk, sizeof(*ch->sim))) ||
+            !(ch->text = malloc((size_t)chunk * PIPE_LINE))) rc = -1;
+        else pipe_queue_push(&p.q[PIPE_PARSE], ch);
+    }
+
+    int n_workers = 0;
+    PipeWorker args[N_PIPE_STAGES];
+    pthread_t *tid = calloc((size_t)N_PIPE_STAGES * (size_t)n_threads, sizeof(*tid));
+    if (!tid) rc = -1;
+    double t0 = now_seconds();
+    if (rc == 0) {
+        fprintf(p.out, "%-24s %-12s %8s %8s %8s %8s", "player", "profile", "minutes", "base", "mult", "proj");
+        if (p.n_sims > 0) fprintf(p.out, " %7s %7s %6s %6s %6s", "mean", "p_over", "p10", "p50", "p90");
+        fprintf(p.out, "\n");
+        for (int s = 0; s < N_PIPE_STAGES; ++s) p.running[s] = PIPE_STAGES[s].parallel ? n_threads : 1;
+        for (int s = 0; s < N_PIPE_STAGES; ++s) {
+            args[s] = (PipeWorker){ &p, s };
+            for (int k = 0; k < p.running[s]; ++k)
+                if (pthread_create(&tid[n_workers], NULL, pipe_worker, &args[s]) == 0) {
+                    ++n_workers;
+                } else {
+                    /* Stand-in exit so the stage still closes its output */
+                    rc = -1;
+                    pthread_mutex_lock(&p.mu);
+                    int last = --p.running[s] == 0;
+                    pthread_mutex_unlock(&p.mu);
+                    if (last && s + 1 < N_PIPE_STAGES) pipe_queue_close(&p.q[s + 1]);
+                }
+        }
+        for (int k = 0; k < n_workers; ++k) pthread_join(tid[k], NULL);
+    }
+    double wall = now_seconds() - t0;
+
+    if (rc == 0 && !p.failed) {
+        int slow = 0;
+        for (int s = 0; s < N_PIPE_STAGES; ++s) {
+            int threads = PIPE_STAGES[s].parallel ? n_threads : 1;
+            fprintf(stderr, "  %-9s %2d thr %10.3f ms busy\n", PIPE_STAGES[s].name, threads, p.busy[s] * 1e3);
+            if (p.busy[s] / threads > p.busy[slow] / (PIPE_STAGES[slow].parallel ? n_threads : 1)) slow = s;
+        }
+        fprintf(stderr, "pipelined %zu rows in %.3f ms; slowest stage %s ~%.3f ms\n", p.rows, wall * 1e3,
+                PIPE_STAGES[slow].name, p.busy[slow] / (PIPE_STAGES[slow].parallel ? n_threads : 1) * 1e3);
+    }
+
+    free(tid);
+    for (int k = 0; chunks && k < p.depth; ++k) {
+        columns_free(&chunks[k].cols);
+        output_columns_free(&chunks[k].out);
+        free(chunks[k].sim);
+        free(chunks[k].text);
+    }
+    for (int s = 0; s < N_PIPE_STAGES; ++s) pipe_queue_free(&p.q[s]);
+    pthread_mutex_destroy(&p.mu);
+    free(chunks);
+    free(p.held);
+    fclose(p.in);
+    if (p.out != stdout && fclose(p.out) != 0) rc = -1;
+    return rc == 0 && !p.failed ? 0 : 1;
+}
+
+/*======================== PRECOMPUTE ========================*/
+
+/* Overnight staging of the next day's slate: once schedules and opening
+ * lines are in, 'points_model precompute' derives minutes, projects every
+ * player and runs the sims on all CPUs at idle priority (nice 19 plus
+ * SCHED_IDLE where the kernel has it), then writes inputs and results to
+ * one snapshot store. In the morning 'batch' and 'sim' on that store skip
+ * straight to output when the model and sim settings still match (see
+ * model_fingerprint()); otherwise they recompute as usual. */
+
+static void lower_cpu_priority(void) {
+    struct sched_param sp;
+    memset(&sp, 0, sizeof(sp));
+    if (setpriority(PRIO_PROCESS, 0, 19) != 0) perror("setpriority");
+#ifdef SCHED_IDLE
+    if (sched_setscheduler(0, SCHED_IDLE, &sp) != 0) perror("sched_setscheduler");
+#endif
+}
+
+static int cmd_precompute(int argc, char **argv) {
+    int n_sims = 10000, n_threads = 0, niceness = 1;
+    uint64_t seed = 1;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--no-nice") == 0) { niceness = 0; --argc; ++argv; continue; }
+        if (argc < 2) break;
+        if (strcmp(argv[0], "--n") == 0)            n_sims = atoi(argv[1]);
+        else if (strcmp(argv[0], "--seed") == 0)    seed = strtoull(argv[1], NULL, 10);
+        else if (strcmp(argv[0], "--threads") == 0) n_threads = atoi(argv[1]);
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 2 || n_sims <= 0) {
+        fprintf(stderr, "usage: points_model precompute [--n sims] [--seed s] [--threads N] [--no-nice] "
+                        "<slate.csv> <out.snap>\n");
+        return 2;
+    }
+    if (niceness) lower_cpu_priority();
+
+    InputColumns c;
+    OutputColumns o;
+    if (slate_load_csv(argv[0], &c) != 0) return 1;
+    SimResult *sim = calloc(c.n ? c.n : 1, sizeof(*sim));
+    double *staged = malloc((c.n ? c.n : 1) * N_STAGED_SIM_COLUMNS * sizeof(double));
+    if (!sim || !staged || output_columns_alloc(&o, c.n) != 0) {
+        free(sim);
+        free(staged);
+        columns_free(&c);
+        return 1;
+    }
+
+    double t0 = now_seconds();
+    minutes_batch(&c, 0, c.n);
+    int rc = numa_run(&c, n_threads, sim_shard, &(SimShard){ n_sims, seed, &o, sim });
+    double t1 = now_seconds();
+
+    SnapExtra extra[3 + N_STAGED_SIM_COLUMNS] = {
+        { "out_base", o.base_points }, { "out_mult", o.final_multiplier }, { "out_proj", o.projection },
+    };
+    for (size_t k = 0; k < N_STAGED_SIM_COLUMNS; ++k) {
+        double *col = staged + k * c.n;
+        for (size_t i = 0; i < c.n; ++i) {
+            const double v[] = { sim[i].mean, sim[i].p_over, sim[i].p10, sim[i].p50, sim[i].p90 };
+            col[i] = v[k];
+        }
+        extra[3 + k] = (SnapExtra){ STAGED_SIM_COLUMNS[k], col };
+    }
+    SnapMeta meta = { model_fingerprint(), seed, (uint32_t)n_sims, 0 };
+    if (rc == 0) rc = snapshot_write(argv[1], &c, NULL, extra, (int)(3 + N_STAGED_SIM_COLUMNS), &meta);
+    if (rc == 0)
+        fprintf(stderr, "staged %zu players (minutes, projections, %d sims) in %.3f ms to %s\n",
+                c.n, n_sims, (t1 - t0) * 1e3, argv[1]);
+
+    free(sim);
+    free(staged);
+    output_columns_free(&o);
+    columns_free(&c);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== MARKET EDGE ========================*/
+
+/* Model vs market per row: P(over) from the simulation (a store's staged
+ * sim_p_over when it has one, else a fresh --n run), the no-vig market
+ * P(over) under each method, and the expected value per unit staked on
+ * the better side at the posted price. The devig and edge passes are
+ * timed on their own; they are a few flat loops over the slate. */
+static int cmd_odds(int argc, char **argv) {
+    int n_sims = 2000;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--n") == 0) n_sims = atoi(argv[1]);
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1 || n_sims <= 0) { fprintf(stderr, "usage: points_model odds [--n sims] <slate|store>\n"); return 2; }
+
+    InputColumns c;
+    Snapshot snap;
+    OutputColumns o;
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    size_t n = c.n;
+    double *p_mkt = malloc((n ? n : 1) * N_DEVIG_METHODS * sizeof(double));
+    double *p_model = malloc((n ? n : 1) * sizeof(double));
+    double *ev = malloc((n ? n : 1) * sizeof(double));
+    char *side = malloc(n ? n : 1);
+    SimResult *sim = malloc((n ? n : 1) * sizeof(*sim));
+    memset(&o, 0, sizeof(o));
+    int rc = p_mkt && p_model && ev && side && sim && output_columns_alloc(&o, n) == 0 ? 0 : -1;
+
+    const double *staged = snapshot_staged(&snap, "sim_p_over");
+    if (rc == 0 && staged) {
+        memcpy(p_model, staged, n * sizeof(double));
+    } else if (rc == 0) {
+        project_batch(&c, 0, n, PROFILE_PER_ROW, &o);
+        simulate_batch(&c, o.projection, 0, n, n_sims, 1, sim);
+        for (size_t i = 0; i < n; ++i) p_model[i] = sim[i].p_over;
+    }
+
+    double t_devig[N_DEVIG_METHODS] = { 0 }, t0 = 0.0, t1 = 0.0;
+    size_t priced = 0;
+    if (rc == 0) {
+        for (int m = 0; m < N_DEVIG_METHODS; ++m) {
+            double t = now_seconds();
+            devig_batch(c.over_price, c.under_price, n, (DevigMethod)m, p_mkt + (size_t)m * n);
+            t_devig[m] = now_seconds() - t;
+        }
+        /* EV of the better side: p * decimal - 1 */
+        t0 = now_seconds();
+        for (size_t i = 0; i < n; ++i) {
+            double ev_over = p_model[i] * price_decimal(c.over_price[i]) - 1.0;
+            double ev_under = (1.0 - p_model[i]) * price_decimal(c.under_price[i]) - 1.0;
+            ev[i] = ev_over > ev_under ? ev_over : ev_under;
+            side[i] = ev_over > ev_under ? 'o' : 'u';
+        }
+        t1 = now_seconds();
+
+        printf("%-24s %6s %7s %7s %7s %7s %7s %7s %8s\n", "player", "line", "over", "under",
+               "mult", "power", "shin", "model", "ev");
+        for (size_t i = 0; i < n; ++i) {
+            if (isnan(c.over_price[i]) || isnan(c.under_price[i])) continue;
+            ++priced;
+            printf("%-24s %6.1f %7g %7g %7.4f %7.4f %7.4f %7.4f %+7.3f%c\n", c.player_name[i],
+                   c.player_line_pts[i], c.over_price[i], c.under_price[i], p_mkt[i], p_mkt[n + i],
+                   p_mkt[2 * n + i], p_model[i], ev[i], side[i]);
+        }
+        fprintf(stderr, "%zu of %zu rows priced; model P(over) %s\n", priced, n,
+                staged ? "from staged sims" : "simulated");
+        for (int m = 0; m < N_DEVIG_METHODS; ++m)
+            fprintf(stderr, "devig %-5s %9.3f us\n", DEVIG_NAMES[m], t_devig[m] * 1e6);
+        fprintf(stderr, "edge       %9.3f us\n", (t1 - t0) * 1e6);
+    }
+
+    free(p_mkt); free(p_model); free(ev); free(side); free(sim);
+    output_columns_free(&o);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== SNAPSHOT DIFF ========================*/
+
+/* Change detection between two slate snapshots (or CSVs), e.g. last
+ * hour's staged store and a fresh pull. Rows are matched by (player,
+ * game). For each numeric field the old column is gathered into new-row
+ * order and compared bit-for-bit (NAN == NAN) in a branch-free loop that
+ * sets one bit per field in a per-row mask; team/archetype changes set
+ * DIFF_IDENTITY_BIT. A row must be recomputed if its mask is non-zero,
+ * it is new, or its game's P(OT) moved (a spread / total edit reaches
+ * every player in the game). All other rows keep the old store's staged
+ * projections and sims, so only affected rows are recomputed; without
+ * staged outputs from the current model every row is.
+ *
+ * With --minutes the new slate goes through the minutes model first, as
+ * precompute does before staging.
+ *
+ * The delta file lists changed rows only:
+ *   DeltaHeader | per row: u32 row, u64 mask,
+ *                          [identity, when DIFF_IDENTITY_BIT is set:
+ *                           char name[NAME_LEN], char team[TEAM_LEN],
+ *                           char game[NAME_LEN], u8 archetype],
+ *                          f64 per set field bit (bits < n_fields), f64 projection
+ *               | per removed row: char name[NAME_LEN], char game[NAME_LEN]
+ * A new row has every field bit and the identity bit set, so the delta
+ * carries everything needed to create it. */
+#define DIFF_IDENTITY_BIT 63
+#define DIFF_NEW_ROW      (((1ULL << N_INPUT_FIELDS) - 1) | 1ULL << DIFF_IDENTITY_BIT)
+#define DELTA_MAGIC       "NBADELT"
+
+_Static_assert(N_INPUT_FIELDS < DIFF_IDENTITY_BIT, "field bits overlap the identity bit");
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_fields;             /* N_INPUT_FIELDS when written */
+    uint64_t n_rows;               /* rows in the new slate */
+    uint64_t n_changed, n_removed;
+    uint64_t model_tag;
+} DeltaHeader;
+
+/* mask[i] |= bit f where new[i] differs from old[map[i]]; rows with
+ * map[i] < 0 are new and must already be DIFF_NEW_ROW. */
+static void diff_field(const double *new_col, const double *old_col, const int *map, size_t n,
+                       int f, double *scratch, uint64_t *mask) {
+    for (size_t i = 0; i < n; ++i) scratch[i] = map[i] >= 0 ? old_col[map[i]] : 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t a, b;
+        memcpy(&a, &new_col[i], sizeof(a));
+        memcpy(&b, &scratch[i], sizeof(b));
+        mask[i] |= (uint64_t)(a != b) << f;
+    }
+}
+
+static int delta_write(const char *path, const InputColumns *c, const uint64_t *mask, const double *proj,
+                       const InputColumns *old, const unsigned char *old_seen, uint64_t model_tag,
+                       size_t *bytes) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) { perror(path); return -1; }
+    DeltaHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DELTA_MAGIC, sizeof(DELTA_MAGIC));
+    h.version = 2;
+    h.n_fields = (uint32_t)N_INPUT_FIELDS;
+    h.n_rows = c->n;
+    h.model_tag = model_tag;
+    for (size_t i = 0; i < c->n; ++i) h.n_changed += mask[i] != 0;
+    for (size_t j = 0; j < old->n; ++j) h.n_removed += !old_seen[j];
+
+    int rc = fwrite(&h, sizeof(h), 1, fp) == 1 ? 0 : -1;
+    for (size_t i = 0; rc == 0 && i < c->n; ++i) {
+        if (!mask[i]) continue;
+        uint32_t row = (uint32_t)i;
+        if (fwrite(&row, sizeof(row), 1, fp) != 1 || fwrite(&mask[i], sizeof(mask[i]), 1, fp) != 1) rc = -1;
+        if (rc == 0 && (mask[i] >> DIFF_IDENTITY_BIT) & 1 &&
+            (fwrite(c->player_name[i], NAME_LEN, 1, fp) != 1 || fwrite(c->team[i], TEAM_LEN, 1, fp) != 1 ||
+             fwrite(c->game[i], NAME_LEN, 1, fp) != 1 || fwrite(&c->archetype[i], 1, 1, fp) != 1)) rc = -1;
+        for (size_t f = 0; rc == 0 && f < N_INPUT_FIELDS; ++f)
+            if ((mask[i] >> f) & 1 && fwrite(&column_ptr((InputColumns *)c, &INPUT_FIELDS[f])[i], sizeof(double), 1, fp) != 1)
+                rc = -1;
+        if (rc == 0 && fwrite(&proj[i], sizeof(double), 1, fp) != 1) rc = -1;
+    }
+    for (size_t j = 0; rc == 0 && j < old->n; ++j)
+        if (!old_seen[j] && (fwrite(old->player_name[j], NAME_LEN, 1, fp) != 1 || fwrite(old->game[j], NAME_LEN, 1, fp) != 1))
+            rc = -1;
+    *bytes = (size_t)ftell(fp);
+    if (fclose(fp) != 0) rc = -1;
+    if (rc != 0) fprintf(stderr, "%s: write failed\n", path);
+    return rc;
+}
+
+static int cmd_diff(int argc, char **argv) {
+    const char *delta_path = NULL, *out_path = NULL;
+    int use_minutes = 0;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--minutes") == 0) { use_minutes = 1; --argc; ++argv; continue; }
+        if (argc < 2) break;
+        if (strcmp(argv[0], "--delta") == 0)    delta_path = argv[1];
+        else if (strcmp(argv[0], "--out") == 0) out_path = argv[1];
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 2) {
+        fprintf(stderr, "usage: points_model diff [--minutes] [--delta out.delta] [--out new.snap] <old> <new>\n");
+        return 2;
+    }
+
+    InputColumns oc, nc;
+    Snapshot os, ns;
+    if (slate_open(argv[0], &oc, &os) != 0) return 1;
+    if (slate_open(argv[1], &nc, &ns) != 0) { columns_free(&oc); snapshot_close(&os); return 1; }
+    if (use_minutes) minutes_batch(&nc, 0, nc.n);
+    size_t n = nc.n;
+
+    int *map = malloc((n ? n : 1) * sizeof(*map));
+    int *next = malloc((oc.n ? oc.n : 1) * sizeof(*next));
+    uint64_t *mask = calloc(n ? n : 1, sizeof(*mask));
+    double *scratch = malloc((n ? n : 1) * sizeof(*scratch));
+    unsigned char *old_seen = calloc(oc.n ? oc.n : 1, 1);
+    unsigned char *ot_moved = calloc(nc.n_games ? nc.n_games : 1, 1);
+    size_t *affected = malloc((n ? n : 1) * sizeof(*affected));
+    SimResult *sim = calloc(n ? n : 1, sizeof(*sim));
+    double *staged = malloc((n ? n : 1) * N_STAGED_SIM_COLUMNS * sizeof(double));
+    OutputColumns o;
+    NameIndex ix;
+    int rc = 0;
+    memset(&o, 0, sizeof(o));
+    memset(&ix, 0, sizeof(ix));
+    if (!map || !next || !mask || !scratch || !old_seen || !ot_moved || !affected || !sim || !staged ||
+        output_columns_alloc(&o, n) != 0 || name_index_init(&ix, oc.n) != 0) rc = -1;
+
+    /* Old rows by name, chained through next[] when a store holds several
+     * games per player; a new row matches the old row with the same game
+     * string (empty when the slate has no game column). */
+    double t0 = now_seconds();
+    for (size_t j = oc.n; rc == 0 && j-- > 0;) {
+        int head = name_index_find(&ix, oc.player_name[j]);
+        next[j] = head;
+        if (name_index_put(&ix, oc.player_name[j], (int)j) != 0) rc = -1;
+    }
+    for (size_t i = 0; rc == 0 && i < n; ++i) {
+        int j = name_index_find(&ix, nc.player_name[i]);
+        while (j >= 0 && (old_seen[j] || strcmp(oc.game[j], nc.game[i]) != 0)) j = next[j];
+        map[i] = j;
+        if (j < 0) { mask[i] = DIFF_NEW_ROW; continue; }
+        old_seen[j] = 1;
+        int same = strcmp(nc.team[i], oc.team[j]) == 0 && nc.archetype[i] == oc.archetype[j];
+        mask[i] |= (uint64_t)!same << DIFF_IDENTITY_BIT;
+    }
+    for (size_t f = 0; rc == 0 && f < N_INPUT_FIELDS; ++f)
+        diff_field(column_ptr(&nc, &INPUT_FIELDS[f]), column_ptr(&oc, &INPUT_FIELDS[f]), map, n, (int)f, scratch, mask);
+    for (size_t i = 0; rc == 0 && i < n; ++i)
+        if (map[i] >= 0 && nc.game_ot_prob[nc.game_idx[i]] != oc.game_ot_prob[oc.game_idx[map[i]]])
+            ot_moved[nc.game_idx[i]] = 1;
+    double t1 = now_seconds();
+
+    /* Reuse the old store's staged outputs for untouched rows */
+    const double *old_out[3] = { snapshot_staged(&os, "out_base"), snapshot_staged(&os, "out_mult"),
+                                 snapshot_staged(&os, "out_proj") };
+    const double *old_sim[N_STAGED_SIM_COLUMNS];
+    int have_out = old_out[0] && old_out[1] && old_out[2], have_sim = have_out && os.hdr->sim_n > 0;
+    for (size_t k = 0; k < N_STAGED_SIM_COLUMNS; ++k)
+        if (!(old_sim[k] = snapshot_staged(&os, STAGED_SIM_COLUMNS[k]))) have_sim = 0;
+
+    size_t n_aff = 0;
+    for (size_t i = 0; rc == 0 && i < n; ++i) {
+        if (mask[i] || ot_moved[nc.game_idx[i]] || !have_out) { affected[n_aff++] = i; continue; }
+        size_t j = (size_t)map[i];
+        o.base_points[i] = old_out[0][j];
+        o.final_multiplier[i] = old_out[1][j];
+        o.projection[i] = old_out[2][j];
+        if (have_sim)
+            sim[i] = (SimResult){ old_sim[0][j], old_sim[1][j], old_sim[2][j], old_sim[3][j], old_sim[4][j] };
+    }
+    /* Recompute affected rows in contiguous runs (sim streams stay keyed by row) */
+    for (size_t a = 0; rc == 0 && a < n_aff;) {
+        size_t b = affected[a], e = b + 1;
+        while (++a < n_aff && affected[a] == e) ++e;
+        OutputColumns run = { o.base_points + b, o.final_multiplier + b, o.projection + b };
+        project_batch(&nc, b, e, PROFILE_PER_ROW, &run);
+        if (have_sim) simulate_batch(&nc, o.projection + b, b, e, (int)os.hdr->sim_n, os.hdr->sim_seed, sim + b);
+    }
+    double t2 = now_seconds();
+
+    if (rc == 0) {
+        size_t changed = 0, removed = 0, field_count[64] = { 0 };
+        for (size_t i = 0; i < n; ++i) {
+            changed += mask[i] != 0;
+            for (int f = 0; f < 64; ++f) field_count[f] += (mask[i] >> f) & 1;
+        }
+        for (size_t j = 0; j < oc.n; ++j) removed += !old_seen[j];
+        printf("%zu rows: %zu changed, %zu removed; recomputed %zu (%.1f%%)%s\n", n, changed, removed, n_aff,
+               n ? 100.0 * (double)n_aff / (double)n : 0.0, have_out ? "" : " - old store has no staged outputs");
+        for (size_t f = 0; f < N_INPUT_FIELDS; ++f)
+            if (field_count[f]) printf("  %-16s %zu\n", INPUT_FIELDS[f].csv_name, field_count[f]);
+        if (field_count[DIFF_IDENTITY_BIT]) printf("  %-16s %zu\n", "team/arch", field_count[DIFF_IDENTITY_BIT]);
+        fprintf(stderr, "diff %.3f ms, recompute %.3f ms\n", (t1 - t0) * 1e3, (t2 - t1) * 1e3);
+    }
+
+    if (rc == 0 && delta_path) {
+        size_t bytes = 0;
+        rc = delta_write(delta_path, &nc, mask, o.projection, &oc, old_seen, model_fingerprint(), &bytes);
+        if (rc == 0) fprintf(stderr, "wrote %zu-byte delta to %s\n", bytes, delta_path);
+    }
+    if (rc == 0 && out_path) {
+        SnapExtra extra[3 + N_STAGED_SIM_COLUMNS] = {
+            { "out_base", o.base_points }, { "out_mult", o.final_multiplier }, { "out_proj", o.projection },
+        };
+        for (size_t k = 0; k < N_STAGED_SIM_COLUMNS; ++k) {
+            double *col = staged + k * n;
+            for (size_t i = 0; i < n; ++i) {
+                const double v[] = { sim[i].mean, sim[i].p_over, sim[i].p10, sim[i].p50, sim[i].p90 };
+                col[i] = v[k];
+            }
+            extra[3 + k] = (SnapExtra){ STAGED_SIM_COLUMNS[k], col };
+        }
+        SnapMeta meta = { model_fingerprint(), have_sim ? os.hdr->sim_seed : 0, have_sim ? os.hdr->sim_n : 0, 0 };
+        rc = snapshot_write(out_path, &nc, NULL, extra, have_sim ? (int)(3 + N_STAGED_SIM_COLUMNS) : 3, &meta);
+    }
+
+    name_index_free(&ix);
+    free(map); free(next); free(mask); free(scratch); free(old_seen); free(ot_moved); free(affected); free(sim); free(staged);
+    output_columns_free(&o);
+    columns_free(&nc);
+    snapshot_close(&ns);
+    columns_free(&oc);
+    snapshot_close(&os);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== FEATURE STORE ========================*/
+
+/* Point-in-time feature values for look-ahead-free backtests. The store is
+ * an append-only CSV log, one observation per line:
+ *
+ *   ts,key,field,value       e.g. 202310241130,p:P012,line,24.5
+ *
+ * ts is yyyymmddHHMM (a bare yyyymmdd means 00:00), key is p:<player name>
+ * or g:<game id> (game-level fields such as spread or game_total), and
+ * field is an INPUT_FIELDS csv name. Players and games are indexed apart,
+ * so a player and a game with the same text never share observations;
+ * both draw key ids from one counter. Loading sorts the log by (field,
+ * key, ts).
+ *
+ * The as-of join assembles each slate row from the newest observation
+ * strictly before its decision time (date + tip, or date + --at for every
+ * row). Queries are sorted once by (key, ts); each field is then a single
+ * merge of two sorted runs rather than a search per row. A player-keyed
+ * value beats a game-keyed one. A field the store knows but has nothing
+ * for yet as of the decision reverts to its missing default, so slate
+ * values from later can never leak in; fields absent from the store keep
+ * the slate's values. */
+#define FEATURE_TS_NONE INT64_MIN
+
+typedef struct {
+    int64_t ts;                    /* yyyymmddHHMM */
+    int key;                       /* FeatureStore.players / games */
+    int field;                     /* INPUT_FIELDS */
+    double value;
+} FeatureObs;
+
+typedef struct {
+    FeatureObs *obs;
+    size_t n, cap;
+    size_t field_begin[N_INPUT_FIELDS + 1];
+    NameIndex players, games;
+} FeatureStore;
+
+typedef struct {
+    int64_t ts;
+    int key;
+    int row;
+} FeatureQuery;
+
+static int64_t feature_ts_parse(const char *s) {
+    char *end;
+    long long v = strtoll(s, &end, 10);
+    if (end == s) return FEATURE_TS_NONE;
+    return v < 100000000LL ? (int64_t)v * 10000 : (int64_t)v;
+}
+
+static int feature_obs_cmp(const void *a, const void *b) {
+    const FeatureObs *x = a, *y = b;
+    if (x->field != y->field) return x->field < y->field ? -1 : 1;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return x->ts < y->ts ? -1 : x->ts > y->ts;
+}
+
+static int feature_query_cmp(const void *a, const void *b) {
+    const FeatureQuery *x = a, *y = b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    if (x->ts != y->ts) return x->ts < y->ts ? -1 : 1;
+    return x->row - y->row;
+}
+
+static void feature_store_free(FeatureStore *fs) {
+    free(fs->obs);
+    name_index_free(&fs->players);
+    name_index_free(&fs->games);
+    memset(fs, 0, sizeof(*fs));
+}
+
+static int feature_store_load(const char *path, FeatureStore *fs) {
+    memset(fs, 0, sizeof(*fs));
+    FILE *fp = fopen(path, "r");
+    if (!fp) { perror(path); return -1; }
+    if (name_index_init(&fs->players, 1024) != 0 || name_index_init(&fs->games, 64) != 0) {
+        feature_store_free(fs);
+        fclose(fp);
+        return -1;
+    }
+
+    char line[4096];
+    int n_keys = 0, rc = 0;
+    size_t lineno = 0;
+    while (rc == 0 && fgets(line, sizeof(line), fp)) {
+        char *f[4];
+        ++lineno;
+        if (line[0] == '#' || line[0] == '\n' || csv_split(line, f, 4) < 4) continue;
+        int64_t ts = feature_ts_parse(f[0]);
+        if (ts == FEATURE_TS_NONE) continue;          /* header */
+        int field = -1;
+        for (size_t k = 0; k < N_INPUT_FIELDS; ++k)
+            if (strcmp(f[2], INPUT_FIELDS[k].csv_name) == 0) field = (int)k;
+        if (field < 0 || INPUT_FIELDS[field].col_off == offsetof(InputColumns, game_date) ||
+            INPUT_FIELDS[field].col_off == offsetof(InputColumns, tipoff)) {
+            fprintf(stderr, "%s:%zu: unknown or non-feature field '%s'\n", path, lineno, f[2]);
+            rc = -1;
+            break;
+        }
+        NameIndex *ix = strncmp(f[1], "p:", 2) == 0 ? &fs->players : strncmp(f[1], "g:", 2) == 0 ? &fs->games : NULL;
+        if (!ix) {
+            fprintf(stderr, "%s:%zu: key '%s' is neither p:<player> nor g:<game>\n", path, lineno, f[1]);
+            rc = -1;
+            break;
+        }
+        int key = name_index_find(ix, f[1] + 2);
+        if (key < 0 && name_index_put(ix, f[1] + 2, key = n_keys++) != 0) rc = -1;
+        if (fs->n == fs->cap) {
+            size_t cap = fs->cap ? fs->cap * 2 : 4096;
+            FeatureObs *obs = realloc(fs->obs, cap * sizeof(*obs));
+            if (!obs) { rc = -1; break; }
+            fs->obs = obs;
+            fs->cap = cap;
+        }
+        fs->obs[fs->n++] = (FeatureObs){ ts, key, field, atof(f[3]) };
+    }
+    fclose(fp);
+    if (rc != 0) { feature_store_free(fs); return -1; }
+
+    qsort(fs->obs, fs->n, sizeof(*fs->obs), feature_obs_cmp);
+    size_t k = 0;
+    for (size_t f = 0; f <= N_INPUT_FIELDS; ++f) {
+        while (k < fs->n && (size_t)fs->obs[k].field < f) ++k;
+        fs->field_begin[f] = k;
+    }
+    return 0;
+}
+
+/* For each query q (sorted by key, ts) set hit[q.row] / value[q.row] from
+ * the last observation in obs[0, n) (sorted by key, ts) with the same key
+ * and ts < q.ts. */
+static void feature_asof_merge(const FeatureObs *obs, size_t n, const FeatureQuery *q, size_t nq,
+                               unsigned char *hit, double *value) {
+    size_t k = 0;
+    for (size_t j = 0; j < nq; ++j) {
+        while (k < n && (obs[k].key < q[j].key || (obs[k].key == q[j].key && obs[k].ts < q[j].ts))) ++k;
+        if (k > 0 && obs[k - 1].key == q[j].key && obs[k - 1].ts < q[j].ts) {
+            hit[q[j].row] = 1;
+            value[q[j].row] = obs[k - 1].value;
+        }
+    }
+}
+
+/* Rewrite c's feature columns as of each row's decision time. at_hhmm < 0
+ * uses the row's tip (00:00 when unknown). */
+static int feature_asof_join(const FeatureStore *fs, InputColumns *c, int at_hhmm, size_t *n_hits) {
+    size_t n = c->n;
+    FeatureQuery *qp = malloc((n ? n : 1) * sizeof(*qp));
+    FeatureQuery *qg = malloc((n ? n : 1) * sizeof(*qg));
+    unsigned char *hit_p = malloc(n ? n : 1), *hit_g = malloc(n ? n : 1);
+    double *val_p = malloc((n ? n : 1) * sizeof(double)), *val_g = malloc((n ? n : 1) * sizeof(double));
+    int rc = qp && qg && hit_p && hit_g && val_p && val_g ? 0 : -1;
+    size_t nqp = 0, nqg = 0;
+
+    for (size_t i = 0; rc == 0 && i < n; ++i) {
+        double hhmm = at_hhmm >= 0 ? at_hhmm : isnan(c->tipoff[i]) ? 0.0 : c->tipoff[i];
+        int64_t ts = (int64_t)c->game_date[i] * 10000 + (int64_t)hhmm;
+        int kp = name_index_find(&fs->players, c->player_name[i]);
+        int kg = c->game[i][0] ? name_index_find(&fs->games, c->game[i]) : -1;
+        if (kp >= 0) qp[nqp++] = (FeatureQuery){ ts, kp, (int)i };
+        if (kg >= 0) qg[nqg++] = (FeatureQuery){ ts, kg, (int)i };
+    }
+    if (rc == 0) {
+        qsort(qp, nqp, sizeof(*qp), feature_query_cmp);
+        qsort(qg, nqg, sizeof(*qg), feature_query_cmp);
+    }
+
+    *n_hits = 0;
+    for (size_t f = 0; rc == 0 && f < N_INPUT_FIELDS; ++f) {
+        const FeatureObs *obs = fs->obs + fs->field_begin[f];
+        size_t m = fs->field_begin[f + 1] - fs->field_begin[f];
+        if (m == 0) continue;
+        memset(hit_p, 0, n);
+        memset(hit_g, 0, n);
+        feature_asof_merge(obs, m, qp, nqp, hit_p, val_p);
+        feature_asof_merge(obs, m, qg, nqg, hit_g, val_g);
+        double *col = column_ptr(c, &INPUT_FIELDS[f]);
+        for (size_t i = 0; i < n; ++i) {
+            col[i] = hit_p[i] ? val_p[i] : hit_g[i] ? val_g[i] : INPUT_FIELDS[f].missing;
+            *n_hits += hit_p[i] | hit_g[i];
+        }
+    }
+    if (rc == 0) {
+        for (size_t i = 0; i < n; ++i) columns_fill_defaults(c, i);
+        rc = games_prepare(c);
+    }
+    free(qp); free(qg); free(hit_p); free(hit_g); free(val_p); free(val_g);
+    return rc;
+}
+
+static int cmd_asof(int argc, char **argv) {
+    const char *out_path = NULL;
+    int at_hhmm = -1;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--at") == 0)       at_hhmm = atoi(argv[1]);
+        else if (strcmp(argv[0], "--out") == 0) out_path = argv[1];
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 2) {
+        fprintf(stderr, "usage: points_model asof [--at HHMM] [--out out.snap] <slate|store> <features.csv>\n");
+        return 2;
+    }
+
+    InputColumns c;
+    Snapshot snap;
+    FeatureStore fs;
+    OutputColumns o;
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    if (feature_store_load(argv[1], &fs) != 0) { columns_free(&c); snapshot_close(&snap); return 1; }
+
+    size_t hits = 0;
+    double t0 = now_seconds();
+    int rc = feature_asof_join(&fs, &c, at_hhmm, &hits);
+    double t1 = now_seconds();
+    if (rc == 0)
+        fprintf(stderr, "as-of join: %zu rows x %zu observations, %zu values in %.3f ms\n",
+                c.n, fs.n, hits, (t1 - t0) * 1e3);
+
+    if (rc == 0 && out_path) {
+        size_t *perm = date_order(&c);
+        rc = perm ? snapshot_write(out_path, &c, perm, NULL, 0, NULL) : -1;
+        free(perm);
+    } else if (rc == 0 && (rc = output_columns_alloc(&o, c.n)) == 0) {
+        project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+        printf("%-24s %-16s %8s %8s %8s %8s\n", "player", "game", "date", "line", "avg", "proj");
+        for (size_t i = 0; i < c.n; ++i)
+            printf("%-24s %-16s %8.0f %8.1f %8.2f %8.2f\n", c.player_name[i], c.game[i], c.game_date[i],
+                   c.player_line_pts[i], c.season_avg_pts[i], o.projection[i]);
+        output_columns_free(&o);
+    }
+
+    feature_store_free(&fs);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== INPUT LOG ========================*/
+
+/* Event-sourced inputs. Every change is appended to a binary log:
+ *
+ *   WalFileHeader | field names | WalRecord [+ payload, padded to 8] | ...
+ *
+ * Events are field sets for one player (WAL_SET), field sets for every
+ * player in a game (WAL_SET_GAME: spread, totals, pace ...), and response
+ * curve reloads (WAL_CURVE, payload = one curves-file line). Each record
+ * carries a sequence number (increasing; numbering continues after the
+ * header's base_seq), the time it was logged (yyyymmddHHMM, non-
+ * decreasing) and a checksum; a torn record at the tail, e.g. after a
+ * crash mid-append, ends the log and is cut off by the next append.
+ *
+ * State = a base slate or store + replay of the events after its wal_seq,
+ * so any moment can be rebuilt with --until. Replay is a linear walk over
+ * the mapped log with one hash lookup per event. Compaction folds the log
+ * into a new store stamped with the last sequence number; --truncate then
+ * rewrites the log keeping only curve events, which a store cannot hold
+ * and which replay applies regardless of the base's wal_seq. Older stores
+ * plus a retained log still reproduce earlier moments, so periodic
+ * compaction replaces minute-by-minute snapshots.
+ *
+ * Set records hold an index into the field-name table the log was created
+ * with, so a build with a different INPUT_FIELDS table maps them by name
+ * and counts fields it lacks as unknown.
+ *
+ * In a multi-day store a player name refers to its latest row. */
+#define WAL_MAGIC   "NBAWAL2"
+#define WAL_MAX_PAYLOAD 512
+#define WAL_MAX_FIELDS  64
+#define WAL_FIELD_NAME  16
+
+_Static_assert(N_INPUT_FIELDS <= WAL_MAX_FIELDS, "WAL field table too small");
+
+enum { WAL_SET = 1, WAL_SET_GAME = 2, WAL_CURVE = 3 };
+
+typedef struct {
+    char magic[8];
+    uint64_t base_seq;             /* sequence numbers start after this */
+    uint32_t n_fields;             /* field names (WAL_FIELD_NAME bytes each) that follow */
+    uint32_t pad;
+} WalFileHeader;
+
+typedef struct {
+    uint64_t seq;
+    int64_t ts;
+    uint16_t type;
+    uint16_t field;                /* INPUT_FIELDS index for sets */
+    uint32_t len;                  /* payload bytes that follow */
+    uint32_t check;                /* FNV-1a of record (check = 0) + payload */
+    uint32_t pad;
+    char key[NAME_LEN];            /* player or game */
+    double value;
+} WalRecord;
+
+typedef struct {
+    void *base;
+    size_t len;                    /* mapped bytes */
+    size_t data;                   /* offset of the first record */
+    size_t end;                    /* offset past the last intact record */
+    uint32_t n_fields;
+    int field_map[WAL_MAX_FIELDS]; /* log field -> INPUT_FIELDS index, -1 unknown */
+    uint64_t base_seq, last_seq;
+    int64_t last_ts;
+    size_t n_records;
+} WalLog;
+
+static size_t wal_padded(uint32_t len) { return (len + 7u) & ~(size_t)7u; }
+
+static uint32_t wal_checksum(const WalRecord *r, const void *payload) {
+    WalRecord tmp = *r;
+    tmp.check = 0;
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < sizeof(tmp); ++k) h = (h ^ ((const unsigned char *)&tmp)[k]) * 16777619u;
+    for (size_t k = 0; k < r->len; ++k) h = (h ^ ((const unsigned char *)payload)[k]) * 16777619u;
+    return h;
+}
+
+static void wal_close(WalLog *w) {
+    if (w->base) munmap(w->base, w->len);
+    memset(w, 0, sizeof(*w));
+}
+
+static int wal_field(const char *name) {
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f)
+        if (strcmp(name, INPUT_FIELDS[f].csv_name) == 0) return (int)f;
+    return -1;
+}
+
+/* Log field index for INPUT_FIELDS index f, -1 if the log has no such field */
+static int wal_log_field(const WalLog *w, int f) {
+    for (uint32_t k = 0; k < w->n_fields; ++k)
+        if (w->field_map[k] == f) return (int)k;
+    return -1;
+}
+
+/* Header plus this build's field names, for a new log */
+static int wal_write_header(FILE *fp, uint64_t base_seq) {
+    WalFileHeader h;
+    char name[WAL_FIELD_NAME];
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, WAL_MAGIC, sizeof(WAL_MAGIC));
+    h.base_seq = base_seq;
+    h.n_fields = (uint32_t)N_INPUT_FIELDS;
+    if (fwrite(&h, sizeof(h), 1, fp) != 1) return -1;
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f) {
+        memset(name, 0, sizeof(name));
+        strncpy(name, INPUT_FIELDS[f].csv_name, sizeof(name) - 1);
+        if (fwrite(name, sizeof(name), 1, fp) != 1) return -1;
+    }
+    return 0;
+}
+
+/* Map a log and find its intact prefix. A missing file is an empty log. */
+static int wal_open(const char *path, WalLog *w) {
+    memset(w, 0, sizeof(*w));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) return 0;
+        perror(path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { perror(path); close(fd); return -1; }
+    w->len = (size_t)st.st_size;
+    if (w->len > 0) {
+        w->base = mmap(NULL, w->len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (w->base == MAP_FAILED) { w->base = NULL; perror(path); close(fd); return -1; }
+    }
+    close(fd);
+    if (w->len == 0) return 0;
+
+    const WalFileHeader *h = w->base;
+    if (w->len < sizeof(*h) || memcmp(h->magic, WAL_MAGIC, sizeof(WAL_MAGIC)) != 0 ||
+        h->n_fields > WAL_MAX_FIELDS || w->len < sizeof(*h) + (size_t)h->n_fields * WAL_FIELD_NAME) {
+        fprintf(stderr, "%s: not an input log\n", path);
+        wal_close(w);
+        return -1;
+    }
+    const char *names = (const char *)(h + 1);
+    w->n_fields = h->n_fields;
+    for (uint32_t k = 0; k < h->n_fields; ++k) {
+        char name[WAL_FIELD_NAME + 1];
+        memcpy(name, names + (size_t)k * WAL_FIELD_NAME, WAL_FIELD_NAME);
+        name[WAL_FIELD_NAME] = 0;
+        w->field_map[k] = wal_field(name);
+    }
+    w->base_seq = h->base_seq;
+    w->last_ts = INT64_MIN;
+    w->data = sizeof(*h) + (size_t)h->n_fields * WAL_FIELD_NAME;
+    size_t off = w->data;
+    while (off + sizeof(WalRecord) <= w->len) {
+        const WalRecord *r = (const WalRecord *)((const char *)w->base + off);
+        size_t next = off + sizeof(*r) + wal_padded(r->len);
+        if (r->len > WAL_MAX_PAYLOAD || next > w->len || r->seq <= w->last_seq ||
+            wal_checksum(r, r + 1) != r->check) break;
+        w->last_seq = r->seq;
+        w->last_ts = r->ts;
+        w->n_records++;
+        off = next;
+    }
+    w->end = off;
+    if (w->last_seq < w->base_seq) w->last_seq = w->base_seq;
+    if (off < w->len) fprintf(stderr, "%s: ignoring %zu torn bytes at the tail\n", path, w->len - off);
+    return 0;
+}
+
+/* Append text events to a log:
+ *     <ts> set <player> <field> <value>
+ *     <ts> game <game> <field> <value>
+ *     <ts> curve <factor> <linear|spline> x:y ...  */
+static int wal_append(const char *path, FILE *in, size_t *n_appended) {
+    WalLog w;
+    if (wal_open(path, &w) != 0) return -1;
+    uint64_t seq = w.last_seq;
+    int64_t last_ts = w.last_ts;
+    size_t end = w.end;
+    int log_field[N_INPUT_FIELDS];         /* records use the log's own field table */
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f) log_field[f] = end ? wal_log_field(&w, (int)f) : (int)f;
+    wal_close(&w);
+
+    int fd = open(path, O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) { perror(path); return -1; }
+    if (ftruncate(fd, (off_t)end) != 0 || lseek(fd, (off_t)end, SEEK_SET) < 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    FILE *fp = fdopen(fd, "wb");
+    if (!fp) { perror(path); close(fd); return -1; }
+    if (end == 0 && wal_write_header(fp, 0) != 0) { perror(path); fclose(fp); return -1; }
+    char line[1024];
+    int lineno = 0, rc = 0;
+    *n_appended = 0;
+    while (rc == 0 && fgets(line, sizeof(line), in)) {
+        ++lineno;
+        char ts_s[32], verb[16], key[NAME_LEN], field[32];
+        double value = 0.0;
+        int used = 0;
+        if (line[0] == '#' || sscanf(line, "%31s %15s %n", ts_s, verb, &used) < 2) continue;
+
+        WalRecord r;
+        memset(&r, 0, sizeof(r));
+        r.ts = feature_ts_parse(ts_s);
+        const char *payload = NULL;
+        if (strcmp(verb, "curve") == 0) {
+            char probe[1024];
+            payload = line + used;
+            r.type = WAL_CURVE;
+            r.len = (uint32_t)strcspn(payload, "\r\n");
+            snprintf(probe, sizeof(probe), "%.*s", (int)r.len, payload);
+            if (r.len > WAL_MAX_PAYLOAD || curve_line_apply(probe, "curve", lineno) <= 0) rc = -1;
+        } else if (sscanf(line + used, "%31s %31s %lf", key, field, &value) == 3 &&
+                   (strcmp(verb, "set") == 0 || strcmp(verb, "game") == 0) && wal_field(field) >= 0) {
+            if (log_field[wal_field(field)] < 0) {
+                fprintf(stderr, "line %d: field '%s' is not in the log's field table; compact with --truncate first\n",
+                        lineno, field);
+                rc = -1;
+                break;
+            }
+            r.type = verb[0] == 's' ? WAL_SET : WAL_SET_GAME;
+            r.field = (uint16_t)log_field[wal_field(field)];
+            snprintf(r.key, sizeof(r.key), "%s", key);
+            r.value = value;
+        } else {
+            rc = -1;
+        }
+        if (rc == 0 && (r.ts == FEATURE_TS_NONE || r.ts < last_ts)) rc = -1;
+        if (rc != 0) {
+            fprintf(stderr, "line %d: expected '<ts> set|game <key> <field> <value>' or '<ts> curve ...' "
+                            "with non-decreasing ts\n", lineno);
+            break;
+        }
+        r.seq = ++seq;
+        r.check = wal_checksum(&r, payload);
+        static const char zero[8];
+        size_t pad = wal_padded(r.len) - r.len;
+        if (fwrite(&r, sizeof(r), 1, fp) != 1 || (r.len && fwrite(payload, r.len, 1, fp) != 1) ||
+            (pad && fwrite(zero, pad, 1, fp) != 1)) rc = -1;
+        last_ts = r.ts;
+        ++*n_appended;
+    }
+    if (fflush(fp) != 0 || fsync(fileno(fp)) != 0) rc = -1;
+    if (fclose(fp) != 0) rc = -1;
+    return rc;
+}
+
+/* Per-row replay bookkeeping for values derived from edited fields */
+enum { WAL_ROW_DEFAULTS = 1, WAL_ROW_PRICE = 2, WAL_ROW_MARKET = 4 };
+
+static void wal_set_row(InputColumns *c, size_t i, double *col, double value, unsigned char *row_state) {
+    columns_unset_defaults(c, i, col, col[i]);
+    row_state[i] |= WAL_ROW_DEFAULTS;
+    if (col == c->over_price || col == c->under_price)
+        row_state[i] = (unsigned char)((row_state[i] & ~WAL_ROW_MARKET) | WAL_ROW_PRICE);
+    else if (col == c->market_p_over)
+        row_state[i] = (unsigned char)((row_state[i] & ~WAL_ROW_PRICE) | WAL_ROW_MARKET);
+    col[i] = value;
+}
+
+/* Apply the log to c: field events after after_seq with ts <= until, and
+ * every curve event with ts <= until. Derived values follow their sources:
+ * copied defaults are refilled and a price edit re-devigs mkt_p_over unless
+ * a later event set it. Returns events applied; *through is the last
+ * sequence number c now reflects. */
+static long wal_replay(const WalLog *w, InputColumns *c, uint64_t after_seq, int64_t until,
+                       uint64_t *through, size_t *n_unknown) {
+    NameIndex players, games;
+    size_t *game_start = calloc(c->n_games + 1, sizeof(size_t));
+    size_t *game_rows = malloc((c->n ? c->n : 1) * sizeof(size_t));
+    unsigned char *row_state = calloc(c->n ? c->n : 1, 1);
+    long applied = -1;
+    memset(&players, 0, sizeof(players));
+    memset(&games, 0, sizeof(games));
+    if (!game_start || !game_rows || !row_state || name_index_init(&players, c->n) != 0 ||
+        name_index_init(&games, c->n_games) != 0)
+        goto done;
+
+    /* Game -> rows (CSR) and name -> row indexes */
+    for (size_t i = 0; i < c->n; ++i) game_start[c->game_idx[i] + 1]++;
+    for (size_t g = 0; g < c->n_games; ++g) game_start[g + 1] += game_start[g];
+    for (size_t i = 0; i < c->n; ++i) game_rows[game_start[c->game_idx[i]]++] = i;
+    memmove(game_start + 1, game_start, c->n_games * sizeof(size_t));
+    game_start[0] = 0;
+    for (size_t i = 0; i < c->n; ++i)
+        if (name_index_put(&players, c->player_name[i], (int)i) != 0 ||
+            (c->game[i][0] && name_index_put(&games, c->game[i], c->game_idx[i]) != 0)) goto done;
+
+    applied = 0;
+    *n_unknown = 0;
+    *through = after_seq;
+    size_t off = w->data;
+    while (off < w->end) {
+        const WalRecord *r = (const WalRecord *)((const char *)w->base + off);
+        off += sizeof(*r) + wal_padded(r->len);
+        if (r->ts > until) break;
+        if (r->seq > *through) *through = r->seq;
+        if (r->type == WAL_CURVE) {
+            char line[WAL_MAX_PAYLOAD + 1];
+            memcpy(line, r + 1, r->len);
+            line[r->len] = 0;
+            if (!FACTOR_CURVES_ON) curves_reset();
+            if (curve_line_apply(line, "log", (int)r->seq) > 0) FACTOR_CURVES_ON = 1;
+            ++applied;
+            continue;
+        }
+        if (r->seq <= after_seq) continue;
+        /* A field this build lacks, or a record from a newer build */
+        if (r->field >= w->n_fields || w->field_map[r->field] < 0 ||
+            (r->type != WAL_SET && r->type != WAL_SET_GAME)) {
+            ++*n_unknown;
+            continue;
+        }
+        double *col = column_ptr(c, &INPUT_FIELDS[w->field_map[r->field]]);
+        if (r->type == WAL_SET) {
+            int i = name_index_find(&players, r->key);
+            if (i < 0) { ++*n_unknown; continue; }
+            wal_set_row(c, (size_t)i, col, r->value, row_state);
+        } else {
+            int g = name_index_find(&games, r->key);
+            if (g < 0) { ++*n_unknown; continue; }
+            for (size_t k = game_start[g]; k < game_start[g + 1]; ++k)
+                wal_set_row(c, game_rows[k], col, r->value, row_state);
+        }
+        ++applied;
+    }
+    for (size_t i = 0; i < c->n; ++i) {
+        if (row_state[i] & WAL_ROW_DEFAULTS) columns_fill_defaults(c, i);
+        if (row_state[i] & WAL_ROW_PRICE) c->market_p_over[i] = NAN;
+    }
+    market_prepare(c, 0, c->n);
+    if (games_prepare(c) != 0) applied = -1;
+
+done:
+    name_index_free(&players);
+    name_index_free(&games);
+    free(game_start);
+    free(game_rows);
+    free(row_state);
+    return applied;
+}
+
+/* Keep only the curve events of a log; numbering continues after last_seq */
+static int wal_truncate(const char *path, const WalLog *w) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) { perror(tmp); return -1; }
+    /* Curve events carry no field index, so the log takes this build's table */
+    int rc = wal_write_header(fp, w->last_seq);
+
+    size_t off = w->data;
+    while (rc == 0 && off < w->end) {
+        const WalRecord *r = (const WalRecord *)((const char *)w->base + off);
+        size_t size = sizeof(*r) + wal_padded(r->len);
+        if (r->type == WAL_CURVE && fwrite(r, size, 1, fp) != 1) rc = -1;
+        off += size;
+    }
+    if (fflush(fp) != 0 || fsync(fileno(fp)) != 0) rc = -1;
+    if (fclose(fp) != 0) rc = -1;
+    if (rc == 0 && rename(tmp, path) != 0) { perror(path); rc = -1; }
+    if (rc != 0) unlink(tmp);
+    return rc;
+}
+
+static int cmd_wal(int argc, char **argv) {
+    const char *verb = argc >= 1 ? argv[0] : "";
+    const char *out_path = NULL;
+    int64_t until = INT64_MAX;
+    int truncate_log = 0;
+    --argc;
+    ++argv;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--truncate") == 0) { truncate_log = 1; --argc; ++argv; continue; }
+        if (argc < 2) break;
+        if (strcmp(argv[0], "--until") == 0)    until = feature_ts_parse(argv[1]);
+        else if (strcmp(argv[0], "--out") == 0) out_path = argv[1];
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (strcmp(verb, "append") == 0 && argc >= 1) {
+        FILE *in = argc >= 2 && strcmp(argv[1], "-") != 0 ? fopen(argv[1], "r") : stdin;
+        if (!in) { perror(argv[1]); return 1; }
+        size_t n = 0;
+        int rc = wal_append(argv[0], in, &n);
+        if (in != stdin) fclose(in);
+        fprintf(stderr, "appended %zu events to %s\n", n, argv[0]);
+        return rc == 0 ? 0 : 1;
+    }
+    int compact = strcmp(verb, "compact") == 0;
+    if (!(compact && argc >= 3) && !(strcmp(verb, "replay") == 0 && argc >= 2)) {
+        fprintf(stderr, "usage: points_model wal append <log> [events|-]\n"
+                        "       points_model wal replay [--until ts] [--out out.snap] <base> <log>\n"
+                        "       points_model wal compact [--truncate] <base> <log> <out.snap>\n");
+        return 2;
+    }
+    if (compact) out_path = argv[2];
+
+    InputColumns c;
+    Snapshot snap;
+    WalLog w;
+    OutputColumns o;
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    if (wal_open(argv[1], &w) != 0) { columns_free(&c); snapshot_close(&snap); return 1; }
+
+    uint64_t after = snap.base ? snap.hdr->wal_seq : 0, through = 0;
+    size_t unknown = 0;
+    double t0 = now_seconds();
+    long applied = wal_replay(&w, &c, after, until, &through, &unknown);
+    double t1 = now_seconds();
+    int rc = applied < 0 ? -1 : 0;
+    if (rc == 0)
+        fprintf(stderr, "replayed %ld of %zu events (%zu for unknown players / games / fields) in %.3f ms, %.1fM events/s\n",
+                applied, w.n_records, unknown, (t1 - t0) * 1e3, (double)applied / ((t1 - t0) * 1e6));
+
+    if (rc == 0 && out_path) {
+        size_t *perm = date_order(&c);
+        SnapMeta meta = { 0, 0, 0, through };
+        rc = perm ? snapshot_write(out_path, &c, perm, NULL, 0, &meta) : -1;
+        free(perm);
+        if (rc == 0) fprintf(stderr, "wrote %zu rows through event %llu to %s\n", c.n,
+                             (unsigned long long)meta.wal_seq, out_path);
+        if (rc == 0 && compact && truncate_log) rc = wal_truncate(argv[1], &w);
+    } else if (rc == 0 && (rc = output_columns_alloc(&o, c.n)) == 0) {
+        project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+        printf("%-24s %-16s %8s %8s %8s\n", "player", "game", "line", "minutes", "proj");
+        for (size_t i = 0; i < c.n; ++i)
+            printf("%-24s %-16s %8.1f %8.1f %8.2f\n", c.player_name[i], c.game[i], c.player_line_pts[i],
+                   c.expected_minutes[i], o.projection[i]);
+        output_columns_free(&o);
+    }
+
+    wal_close(&w);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== TREE ENSEMBLE ========================*/
+
+/* Alternative engine: a gradient-boosted tree ensemble over the same Inputs
+ * features, predicting points directly. Models are read from an XGBoost-style
+ * text dump:
+ *
+ *     base_score=12.5
+ *     booster[0]:
+ *     0:[season_avg<20.5] yes=1,no=2,missing=1
+ *         1:leaf=-1.25
+ *         2:leaf=2.5
+ *
+ * Features are named by slate CSV column (or f<k>, k = INPUT_FIELDS index);
+ * "archetype" is the profile index and has no f<k> alias, so the indices
+ * stay put as fields are appended. "yes" is taken when x < threshold; a
+ * NAN feature (recent_avg, exp_min, tip ... when unknown) takes the node's
+ * missing= branch, "no" when the dump gives none.
+ *
+ * At load every tree is padded to a complete binary tree of the ensemble's
+ * max depth and stored level-order in flat arrays, so traversal is a fixed
+ * number of `i = 2i + 1 + (x >= t)` steps with no data-dependent branches.
+ * Shallow leaves become pass-through nodes (threshold +inf, always "yes")
+ * whose whole subtree carries the leaf value. */
+#define TREE_MAX_DEPTH   12
+#define TREE_BLOCK       64
+#define N_TREE_FEATURES  (N_INPUT_FIELDS + 1)   /* + archetype index */
+
+typedef struct {
+    int n_trees;
+    int depth;
+    int n_internal;            /* per tree: 2^depth - 1 */
+    int n_leaves;              /* per tree: 2^depth */
+    double base_score;
+    unsigned short *feature;   /* [n_trees * n_internal] */
+    double *threshold;         /* [n_trees * n_internal] */
+    unsigned char *missing_yes;/* [n_trees * n_internal]: NAN goes "yes" */
+    double *leaf;              /* [n_trees * n_leaves] */
+} TreeEnsemble;
+
+typedef struct {
+    int used, is_leaf, feature, yes, no, missing_yes;
+    double value;
+} DumpNode;
+
+typedef struct {
+    DumpNode *node;
+    int cap;
+} DumpTree;
+
+static int tree_feature_index(const char *name) {
+    if (name[0] == 'f' && name[1] >= '0' && name[1] <= '9') {
+        int k = atoi(name + 1);
+        return k < (int)N_INPUT_FIELDS ? k : -1;
+    }
+    if (strcmp(name, "archetype") == 0) return (int)N_INPUT_FIELDS;
+    for (size_t f = 0; f < N_INPUT_FIELDS; ++f)
+        if (strcmp(name, INPUT_FIELDS[f].csv_name) == 0) return (int)f;
+    return -1;
+}
+
+static int dump_depth(const DumpTree *t, int id, int depth) {
+    if (id < 0 || id >= t->cap || !t->node[id].used) return -1;
+    if (t->node[id].is_leaf) return depth;
+    if (depth >= TREE_MAX_DEPTH) return -1;
+    int l = dump_depth(t, t->node[id].yes, depth + 1);
+    int r = dump_depth(t, t->node[id].no, depth + 1);
+    if (l < 0 || r < 0) return -1;
+    return l > r ? l : r;
+}
+
+/* Write node `id` of a dump tree into slot `pos` of flattened tree `dst` */
+static void tree_fill(TreeEnsemble *m, int dst, const DumpTree *t, int id, int pos) {
+    unsigned short *feat = m->feature + (size_t)dst * m->n_internal;
+    double *thr = m->threshold + (size_t)dst * m->n_internal;
+    unsigned char *miss = m->missing_yes + (size_t)dst * m->n_internal;
+    double *leaf = m->leaf + (size_t)dst * m->n_leaves;
+    const DumpNode *nd = &t->node[id];
+
+    if (pos >= m->n_internal) {
+        leaf[pos - m->n_internal] = nd->value;
+    } else if (nd->is_leaf) {
+        feat[pos] = 0;
+        thr[pos] = INFINITY;
+        miss[pos] = 1;
+        tree_fill(m, dst, t, id, 2 * pos + 1);
+        tree_fill(m, dst, t, id, 2 * pos + 2);
+    } else {
+        feat[pos] = (unsigned short)nd->feature;
+        thr[pos] = nd->value;
+        miss[pos] = (unsigned char)nd->missing_yes;
+        tree_fill(m, dst, t, nd->yes, 2 * pos + 1);
+        tree_fill(m, dst, t, nd->no, 2 * pos + 2);
+    }
+}
+
+static void tree_free(TreeEnsemble *m) {
+    free(m->feature);
+    free(m->threshold);
+    free(m->missing_yes);
+    free(m->leaf);
+    memset(m, 0, sizeof(*m));
+}
+
+static int tree_load(const char *path, TreeEnsemble *m) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) { perror(path); return -1; }
+    memset(m, 0, sizeof(*m));
+
+    DumpTree *trees = NULL;
+    int n_trees = 0, rc = 0, lineno = 0;
+    char line[512];
+
+    while (rc == 0 && fgets(line, sizeof(line), fp)) {
+        ++lineno;
+        char *p = line;
+        while (*p == ' ' || *p == '\t') ++p;
+        if (*p == '\n' || *p == '\r' || *p == 0 || *p == '#') continue;
+
+        if (sscanf(p, "base_score=%lf", &m->base_score) == 1) continue;
+        if (strncmp(p, "booster[", 8) == 0) {
+            DumpTree *nt = realloc(trees, (size_t)(n_trees + 1) * sizeof(*trees));
+            if (!nt) { rc = -1; break; }
+            trees = nt;
+            memset(&trees[n_trees++], 0, sizeof(*trees));
+            continue;
+        }
+
+        int id, missing = -1, used = 0;
+        DumpNode nd;
+        memset(&nd, 0, sizeof(nd));
+        char fname[64];
+        if (n_trees > 0 && sscanf(p, "%d:leaf=%lf", &id, &nd.value) == 2) {
+            nd.is_leaf = 1;
+            used = 1;
+        } else if (n_trees > 0 &&
+                   sscanf(p, "%d:[%63[^<]<%lf] yes=%d,no=%d,missing=%d", &id, fname, &nd.value, &nd.yes, &nd.no,
+                          &missing) >= 5) {
+            nd.feature = tree_feature_index(fname);
+            nd.missing_yes = missing == nd.yes;
+            used = nd.feature >= 0 && (missing < 0 || missing == nd.yes || missing == nd.no);
+        }
+        if (!used || id < 0) {
+            fprintf(stderr, "%s:%d: unrecognized tree dump line\n", path, lineno);
+            rc = -1;
+            break;
+        }
+
+        DumpTree *t = &trees[n_trees - 1];
+        if (id >= t->cap) {
+            int cap = t->cap ? t->cap : 16;
+            while (cap <= id) cap *= 2;
+            DumpNode *nn = realloc(t->node, (size_t)cap * sizeof(*nn));
+            if (!nn) { rc = -1; break; }
+            memset(nn + t->cap, 0, (size_t)(cap - t->cap) * sizeof(*nn));
+            t->node = nn;
+            t->cap = cap;
+        }
+        nd.used = 1;
+        t->node[id] = nd;
+    }
+    fclose(fp);
+
+    int depth = 0;
+    for (int k = 0; rc == 0 && k < n_trees; ++k) {
+        int d = dump_depth(&trees[k], 0, 0);
+        if (d < 0) {
+            fprintf(stderr, "%s: booster[%d] is incomplete or deeper than %d\n", path, k, TREE_MAX_DEPTH);
+            rc = -1;
+        }
+        if (d > depth) depth = d;
+    }
+    if (rc == 0 && n_trees == 0) {
+        fprintf(stderr, "%s: no trees\n", path);
+        rc = -1;
+    }
+
+    if (rc == 0) {
+        m->n_trees = n_trees;
+        m->depth = depth;
+        m->n_internal = (1 << depth) - 1;
+        m->n_leaves = 1 << depth;
+        m->feature = calloc((size_t)n_trees * (m->n_internal ? m->n_internal : 1), sizeof(*m->feature));
+        m->threshold = calloc((size_t)n_trees * (m->n_internal ? m->n_internal : 1), sizeof(*m->threshold));
+        m->missing_yes = calloc((size_t)n_trees * (m->n_internal ? m->n_internal : 1), sizeof(*m->missing_yes));
+        m->leaf = calloc((size_t)n_trees * m->n_leaves, sizeof(*m->leaf));
+        if (!m->feature || !m->threshold || !m->missing_yes || !m->leaf) rc = -1;
+        for (int k = 0; rc == 0 && k < n_trees; ++k) tree_fill(m, k, &trees[k], 0, 0);
+    }
+
+    for (int k = 0; k < n_trees; ++k) free(trees[k].node);
+    free(trees);
+    if (rc != 0) tree_free(m);
+    return rc;
+}
+
+/* Score rows [begin, end) into out[0, end - begin). Rows are processed in blocks: the block's features
+ * are transposed once into a small row-major buffer, then each tree (whose
+ * nodes stay hot in L1) is walked by every row of the block. */
+static void tree_score_batch(const TreeEnsemble *m, const InputColumns *c,
+                             size_t begin, size_t end, double *out) {
+    double x[TREE_BLOCK][N_TREE_FEATURES];
+    double acc[TREE_BLOCK];
+    int idx[TREE_BLOCK];
+    const int ni = m->n_internal;
+
+    for (size_t b = begin; b < end; b += TREE_BLOCK) {
+        size_t nb = end - b < TREE_BLOCK ? end - b : TREE_BLOCK;
+        for (size_t f = 0; f < N_INPUT_FIELDS; ++f) {
+            const double *col = column_ptr((InputColumns *)c, &INPUT_FIELDS[f]);
+            for (size_t r = 0; r < nb; ++r) x[r][f] = col[b + r];
+        }
+        for (size_t r = 0; r < nb; ++r) {
+            x[r][N_INPUT_FIELDS] = c->archetype[b + r];
+            acc[r] = m->base_score;
+        }
+
+        for (int t = 0; t < m->n_trees; ++t) {
+            const unsigned short *feat = m->feature + (size_t)t * ni;
+            const double *thr = m->threshold + (size_t)t * ni;
+            const unsigned char *miss = m->missing_yes + (size_t)t * ni;
+            const double *leaf = m->leaf + (size_t)t * m->n_leaves;
+            /* Level by level across the block: the rows' walks are
+             * independent, so their loads overlap instead of serializing */
+            for (size_t r = 0; r < nb; ++r) idx[r] = 0;
+            for (int d = 0; d < m->depth; ++d)
+                for (size_t r = 0; r < nb; ++r) {
+                    double v = x[r][feat[idx[r]]];
+                    idx[r] = 2 * idx[r] + 1 + (!(v < thr[idx[r]]) & !(isnan(v) & miss[idx[r]]));
+                }
+            for (size_t r = 0; r < nb; ++r) acc[r] += leaf[idx[r] - ni];
+        }
+        for (size_t r = 0; r < nb; ++r) out[b - begin + r] = acc[r];
+    }
+}
+
+static int cmd_tree(int argc, char **argv) {
+    if (argc < 2) { fprintf(stderr, "usage: points_model tree <model.txt> <slate.csv>\n"); return 2; }
+
+    TreeEnsemble m;
+    InputColumns c;
+    OutputColumns o;
+    if (tree_load(argv[0], &m) != 0) return 1;
+    if (slate_load_csv(argv[1], &c) != 0) { tree_free(&m); return 1; }
+    double *tree_proj = calloc(c.n ? c.n : 1, sizeof(double));
+    if (!tree_proj || output_columns_alloc(&o, c.n) != 0) { tree_free(&m); columns_free(&c); free(tree_proj); return 1; }
+
+    project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+    double t0 = now_seconds();
+    tree_score_batch(&m, &c, 0, c.n, tree_proj);
+    double t1 = now_seconds();
+
+    printf("%-24s %10s %10s\n", "player", "mult_proj", "tree_proj");
+    for (size_t i = 0; i < c.n; ++i)
+        printf("%-24s %10.2f %10.2f\n", c.player_name[i], o.projection[i], tree_proj[i]);
+    fprintf(stderr, "scored %zu players x %d trees (depth %d) in %.3f ms\n",
+            c.n, m.n_trees, m.depth, (t1 - t0) * 1e3);
+
+    free(tree_proj);
+    output_columns_free(&o);
+    columns_free(&c);
+    tree_free(&m);
+    return 0;
+}
+
+/*======================== MODEL ENSEMBLE ========================*/
+
+/* Blend several engines in one pass over a slate. Rows are walked in tiles
+ * small enough that the tile's input columns stay in L1/L2: every member is
+ * evaluated on the tile, then the weighted blend is accumulated, so the slate
+ * is streamed from memory once no matter how many members there are.
+ *
+ * Spec string, comma separated, weights normalized to sum to 1:
+ *     mult:0.5                  multiplicative model, per-row archetype
+ *     profile=usage_guard:0.2   multiplicative model, one fixed profile
+ *     tree=model.txt:0.3        tree ensemble dump */
+#define ENSEMBLE_TILE        256
+#define ENSEMBLE_MAX_MEMBERS 8
+
+typedef enum { MEMBER_MULT, MEMBER_TREE } MemberKind;
+
+typedef struct {
+    MemberKind kind;
+    int profile;               /* MEMBER_MULT: PROFILE_PER_ROW or archetype */
+    TreeEnsemble tree;         /* MEMBER_TREE */
+    double weight;
+    char label[24];
+} EnsembleMember;
+
+typedef struct {
+    int n;
+    EnsembleMember m[ENSEMBLE_MAX_MEMBERS];
+} Ensemble;
+
+static void ensemble_free(Ensemble *e) {
+    for (int k = 0; k < e->n; ++k)
+        if (e->m[k].kind == MEMBER_TREE) tree_free(&e->m[k].tree);
+    e->n = 0;
+}
+
+static int ensemble_parse(const char *spec, Ensemble *e) {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    memset(e, 0, sizeof(*e));
+
+    double total = 0.0;
+    for (char *item = strtok(buf, ","); item; item = strtok(NULL, ",")) {
+        char *colon = strrchr(item, ':');
+        if (!colon || e->n == ENSEMBLE_MAX_MEMBERS) {
+            fprintf(stderr, "ensemble: bad member '%s' (want kind[=arg]:weight, max %d)\n",
+                    item, ENSEMBLE_MAX_MEMBERS);
+            ensemble_free(e);
+            return -1;
+        }
+        *colon = 0;
+        EnsembleMember *m = &e->m[e->n];
+        m->weight = strtod(colon + 1, NULL);
+        char *arg = strchr(item, '=');
+        if (arg) *arg++ = 0;
+
+        if (strcmp(item, "mult") == 0) {
+            m->kind = MEMBER_MULT;
+            m->profile = PROFILE_PER_ROW;
+            snprintf(m->label, sizeof(m->label), "mult");
+        } else if (strcmp(item, "profile") == 0 && arg) {
+            m->kind = MEMBER_MULT;
+            m->profile = archetype_from_name(arg);
+            snprintf(m->label, sizeof(m->label), "%s", ARCHETYPE_SCALES[m->profile].name);
+        } else if (strcmp(item, "tree") == 0 && arg) {
+            m->kind = MEMBER_TREE;
+            if (tree_load(arg, &m->tree) != 0) { ensemble_free(e); return -1; }
+            snprintf(m->label, sizeof(m->label), "tree%d", e->n);
+        } else {
+            fprintf(stderr, "ensemble: unknown member '%s'\n", item);
+            ensemble_free(e);
+            return -1;
+        }
+        total += m->weight;
+        e->n++;
+    }
+    if (e->n == 0 || total <= 0.0) {
+        fprintf(stderr, "ensemble: need at least one member with positive weight\n");
+        ensemble_free(e);
+        return -1;
+    }
+    for (int k = 0; k < e->n; ++k) e->m[k].weight /= total;
+    return 0;
+}
+
+/* Blend rows [begin, end) into blend[0 .. end-begin). If member_out is not
+ * NULL it receives each member's projection, row-major [row * e->n + k]. */
+static void ensemble_project(const Ensemble *e, const InputColumns *c, size_t begin, size_t end,
+                             double *blend, double *member_out) {
+    double base[ENSEMBLE_TILE], mult[ENSEMBLE_TILE], proj[ENSEMBLE_TILE];
+    OutputColumns tile_out = { base, mult, proj };
+
+    for (size_t t = begin; t < end; t += ENSEMBLE_TILE) {
+        size_t te = end - t < ENSEMBLE_TILE ? end : t + ENSEMBLE_TILE;
+        size_t nt = te - t;
+        double *acc = blend + (t - begin);
+        for (size_t r = 0; r < nt; ++r) acc[r] = 0.0;
+
+        for (int k = 0; k < e->n; ++k) {
+            const EnsembleMember *m = &e->m[k];
+            if (m->kind == MEMBER_MULT) project_batch(c, t, te, m->profile, &tile_out);
+            else                        tree_score_batch(&m->tree, c, t, te, proj);
+
+            for (size_t r = 0; r < nt; ++r) acc[r] += m->weight * proj[r];
+            if (member_out)
+                for (size_t r = 0; r < nt; ++r) member_out[(t - begin + r) * e->n + k] = proj[r];
+        }
+    }
+}
+
+static int cmd_ensemble(int argc, char **argv) {
+    if (argc < 2) { fprintf(stderr, "usage: points_model ensemble <spec> <slate.csv>\n"); return 2; }
+
+    Ensemble e;
+    InputColumns c;
+    if (ensemble_parse(argv[0], &e) != 0) return 1;
+    if (slate_load_csv(argv[1], &c) != 0) { ensemble_free(&e); return 1; }
+    double *blend = calloc(c.n ? c.n : 1, sizeof(double));
+    double *members = calloc((c.n ? c.n : 1) * (size_t)e.n, sizeof(double));
+    if (!blend || !members) { free(blend); free(members); columns_free(&c); ensemble_free(&e); return 1; }
+
+    double t0 = now_seconds();
+    ensemble_project(&e, &c, 0, c.n, blend, members);
+    double t1 = now_seconds();
+
+    printf("%-24s", "player");
+    for (int k = 0; k < e.n; ++k) printf(" %12s", e.m[k].label);
+    printf(" %10s\n", "blend");
+    for (size_t i = 0; i < c.n; ++i) {
+        printf("%-24s", c.player_name[i]);
+        for (int k = 0; k < e.n; ++k) printf(" %12.2f", members[i * e.n + k]);
+        printf(" %10.2f\n", blend[i]);
+    }
+    fprintf(stderr, "blended %d models over %zu players in %.3f ms\n", e.n, c.n, (t1 - t0) * 1e3);
+
+    free(blend);
+    free(members);
+    columns_free(&c);
+    ensemble_free(&e);
+    return 0;
+}
+
+/*======================== TEAMMATE ABSENCES ========================*/
+
+/* When players are ruled out, their load is shared out among available
+ * teammates on the same team:
+ *   - minutes go to teammates in proportion to their baseline minutes,
+ *     water-filled so nobody passes MAX_PLAYER_MINUTES;
+ *   - the usage-minutes the team lost are shared in proportion to usage^2 x
+ *     minutes, so high-usage players absorb more of it, and W_USAGE_SHIFT of
+ *     each player's relative usage gain scales their usage_multiplier.
+ * Full-roster baselines are captured once, so every call recomputes a team
+ * from scratch (players can be ruled out and back in) and touches only that
+ * team's rows. The slate's own usage_mult is part of that baseline: the
+ * absence shift multiplies it, and a player ruled back in gets it back. */
+typedef struct {
+    char team[TEAM_LEN];
+    int n;
+    size_t *row;               /* slate rows on this team */
+    double *base_minutes;      /* full-roster expected minutes */
+    double *usage;             /* baseline usage rate */
+    double *usage_mult;        /* slate usage multiplier */
+    double *minutes;           /* scratch: redistributed minutes */
+} TeamRoster;
+
+typedef struct {
+    int n_teams;
+    TeamRoster *team;
+    int *team_of_row;          /* slate row -> index into team */
+} Rosters;
+
+static void rosters_free(Rosters *r) {
+    for (int t = 0; t < r->n_teams; ++t) {
+        free(r->team[t].row);
+        free(r->team[t].base_minutes);
+        free(r->team[t].usage);
+        free(r->team[t].usage_mult);
+        free(r->team[t].minutes);
+    }
+    free(r->team);
+    free(r->team_of_row);
+    memset(r, 0, sizeof(*r));
+}
+
+static int rosters_build(Rosters *r, const InputColumns *c) {
+    memset(r, 0, sizeof(*r));
+    r->team_of_row = malloc((c->n ? c->n : 1) * sizeof(int));
+    r->team = calloc(c->n ? c->n : 1, sizeof(TeamRoster));
+    if (!r->team_of_row || !r->team) { rosters_free(r); return -1; }
+
+    /* Pass 1: assign team indices and count */
+    for (size_t i = 0; i < c->n; ++i) {
+        int t = 0;
+        while (t < r->n_teams && strcmp(r->team[t].team, c->team[i]) != 0) ++t;
+        if (t == r->n_teams) snprintf(r->team[r->n_teams++].team, TEAM_LEN, "%s", c->team[i]);
+        r->team_of_row[i] = t;
+        r->team[t].n++;
+    }
+    for (int t = 0; t < r->n_teams; ++t) {
+        TeamRoster *tr = &r->team[t];
+        tr->row = malloc((size_t)tr->n * sizeof(*tr->row));
+        tr->base_minutes = malloc((size_t)tr->n * sizeof(double));
+        tr->usage = malloc((size_t)tr->n * sizeof(double));
+        tr->usage_mult = malloc((size_t)tr->n * sizeof(double));
+        tr->minutes = malloc((size_t)tr->n * sizeof(double));
+        if (!tr->row || !tr->base_minutes || !tr->usage || !tr->usage_mult || !tr->minutes) {
+            rosters_free(r);
+            return -1;
+        }
+        tr->n = 0;
+    }
+    /* Pass 2: capture baselines */
+    for (size_t i = 0; i < c->n; ++i) {
+        TeamRoster *tr = &r->team[r->team_of_row[i]];
+        int k = tr->n++;
+        tr->row[k] = i;
+        tr->base_minutes[k] = c->expected_minutes[i] > 0.0 ? c->expected_minutes[i] : c->season_avg_minutes[i];
+        tr->usage[k] = c->usage_rate[i];
+        tr->usage_mult[k] = c->usage_multiplier[i];
+    }
+    return 0;
+}
+
+/* Recompute team t from its availability flags (c->is_out) and re-project
+ * its rows into o. Returns the number of rows updated. */
+static int roster_update(Rosters *r, int t, InputColumns *c, OutputColumns *o) {
+    TeamRoster *tr = &r->team[t];
+    double freed = 0.0;
+
+    for (int k = 0; k < tr->n; ++k) {
+        int out = c->is_out[tr->row[k]] != 0.0;
+        tr->minutes[k] = out ? 0.0 : tr->base_minutes[k];
+        freed += out ? tr->base_minutes[k] : 0.0;
+    }
+
+    /* Water-fill the freed minutes */
+    for (int iter = 0; iter < 8 && freed > 1e-9; ++iter) {
+        double share_base = 0.0;
+        for (int k = 0; k < tr->n; ++k)
+            if (tr->minutes[k] > 0.0 && tr->minutes[k] < MAX_PLAYER_MINUTES) share_base += tr->base_minutes[k];
+        if (share_base <= 0.0) break;
+
+        double given = 0.0;
+        for (int k = 0; k < tr->n; ++k) {
+            if (!(tr->minutes[k] > 0.0 && tr->minutes[k] < MAX_PLAYER_MINUTES)) continue;
+            double add = freed * tr->base_minutes[k] / share_base;
+            if (tr->minutes[k] + add > MAX_PLAYER_MINUTES) add = MAX_PLAYER_MINUTES - tr->minutes[k];
+            tr->minutes[k] += add;
+            given += add;
+        }
+        freed -= given;
+    }
+
+    /* Usage-minutes the available players still have to cover */
+    double team_mass = 0.0, avail_mass = 0.0, weight_mass = 0.0;
+    for (int k = 0; k < tr->n; ++k) {
+        team_mass   += tr->usage[k] * tr->base_minutes[k];
+        avail_mass  += tr->usage[k] * tr->minutes[k];
+        weight_mass += tr->usage[k] * tr->usage[k] * tr->minutes[k];
+    }
+    double deficit = team_mass > avail_mass ? team_mass - avail_mass : 0.0;
+
+    for (int k = 0; k < tr->n; ++k) {
+        size_t i = tr->row[k];
+        double gain = weight_mass > 0.0 ? deficit * tr->usage[k] / weight_mass : 0.0;
+        double mult = 1.0 + W_USAGE_SHIFT * gain;
+        c->expected_minutes[i] = tr->minutes[k];
+        if (c->is_out[i] != 0.0) mult = 1.0;
+        else if (mult > USAGE_MULT_MAX) mult = USAGE_MULT_MAX;
+        c->usage_multiplier[i] = tr->usage_mult[k] * mult;
+
+        OutputColumns row = { &o->base_points[i], &o->final_multiplier[i], &o->projection[i] };
+        project_batch(c, i, i + 1, PROFILE_PER_ROW, &row);
+    }
+    return tr->n;
+}
+
+static int cmd_scratch(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: points_model scratch <slate.csv> <player>[,<player>...]\n");
+        return 2;
+    }
+
+    InputColumns c;
+    OutputColumns o;
+    Rosters r;
+    if (slate_load_csv(argv[0], &c) != 0) return 1;
+    if (output_columns_alloc(&o, c.n) != 0 || rosters_build(&r, &c) != 0) {
+        output_columns_free(&o);
+        columns_free(&c);
+        return 1;
+    }
+    double *before = malloc((c.n ? c.n : 1) * sizeof(double));
+    unsigned char *dirty = calloc(r.n_teams ? (size_t)r.n_teams : 1, 1);
+    if (!before || !dirty) { free(before); free(dirty); rosters_free(&r); output_columns_free(&o); columns_free(&c); return 1; }
+
+    /* Baseline: the slate as loaded, with absences it already marks shared
+     * out; teams with nobody out keep their loaded minutes and usage_mult */
+    project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+    for (size_t i = 0; i < c.n; ++i)
+        if (c.is_out[i] != 0.0) dirty[r.team_of_row[i]] = 1;
+    for (int t = 0; t < r.n_teams; ++t)
+        if (dirty[t]) roster_update(&r, t, &c, &o);
+    memcpy(before, o.projection, c.n * sizeof(double));
+    memset(dirty, 0, (size_t)r.n_teams);
+
+    char names[512];
+    snprintf(names, sizeof(names), "%s", argv[1]);
+    for (char *nm = strtok(names, ","); nm; nm = strtok(NULL, ",")) {
+        size_t i = 0;
+        while (i < c.n && strcmp(c.player_name[i], nm) != 0) ++i;
+        if (i == c.n) { fprintf(stderr, "scratch: no player '%s' in slate\n", nm); continue; }
+        c.is_out[i] = 1.0;
+        dirty[r.team_of_row[i]] = 1;
+    }
+
+    double t0 = now_seconds();
+    int updated = 0;
+    for (int t = 0; t < r.n_teams; ++t)
+        if (dirty[t]) updated += roster_update(&r, t, &c, &o);
+    double t1 = now_seconds();
+
+    printf("%-24s %-6s %8s %8s %8s %8s\n", "player", "team", "minutes", "usage", "before", "after");
+    for (size_t i = 0; i < c.n; ++i) {
+        if (!dirty[r.team_of_row[i]]) continue;
+        printf("%-24s %-6s %8.1f %8.3f %8.2f %8.2f%s\n", c.player_name[i], c.team[i],
+               c.expected_minutes[i], c.usage_multiplier[i], before[i], o.projection[i],
+               c.is_out[i] != 0.0 ? "  OUT" : "");
+    }
+    fprintf(stderr, "re-projected %d players in %.3f ms\n", updated, (t1 - t0) * 1e3);
+
+    free(before);
+    free(dirty);
+    rosters_free(&r);
+    output_columns_free(&o);
+    columns_free(&c);
+    return 0;
+}
+
+/*======================== LIVE UPDATES ========================*/
+
+/* In-game projection of final points from a play-by-play / box-score event
+ * stream. Each event is one CSV line:
+ *
+ *     game,clock,player,type,value
+ *
+ * clock is elapsed game seconds; type is PTS (value = points), IN / OUT
+ * (substitutions), PF (personal foul) or CLOCK (game clock only, player
+ * empty). A player event is O(1): two hash lookups and a closed-form
+ * update. A CLOCK event re-projects every active row of its game (the
+ * slate's rows for that game plus players seen in its events), since
+ * everyone's remaining time shrinks with the clock.
+ *
+ * For a player with pregame projection P over E expected minutes:
+ *   rate  = (P/E * LIVE_PRIOR_MINUTES + points) / (LIVE_PRIOR_MINUTES + played)
+ *   left  = min(E * remaining/regulation, remaining) * foul factor
+ *   final = points + rate * left
+ * so the pregame rate is shrunk toward what the player is actually doing. */
+typedef struct {
+    double points;
+    double seconds;            /* banked playing time, excluding the current stint */
+    double stint_start;        /* game clock at sub-in; < 0 when on the bench */
+    int fouls;
+    int game;                  /* index into LiveState.game, -1 until first event */
+    double final_projection;
+} LivePlayer;
+
+typedef struct {
+    char id[NAME_LEN];
+    double clock;              /* elapsed seconds */
+    int *rows;                 /* slate rows in this game */
+    int n_rows, cap_rows;
+} LiveGame;
+
+typedef struct {
+    const InputColumns *c;
+    const double *pregame;     /* pregame projection per slate row */
+    LivePlayer *player;        /* per slate row */
+    NameIndex players;
+    NameIndex games;
+    LiveGame *game;
+    int n_games, cap_games;
+} LiveState;
+
+static void live_free(LiveState *s) {
+    for (int g = 0; g < s->n_games; ++g) free(s->game[g].rows);
+    free(s->player);
+    free(s->game);
+    name_index_free(&s->players);
+    name_index_free(&s->games);
+    memset(s, 0, sizeof(*s));
+}
+
+static int live_init(LiveState *s, const InputColumns *c, const double *pregame) {
+    memset(s, 0, sizeof(*s));
+    s->c = c;
+    s->pregame = pregame;
+    s->player = calloc(c->n ? c->n : 1, sizeof(*s->player));
+    if (!s->player || name_index_init(&s->players, c->n) != 0 || name_index_init(&s->games, 16) != 0) {
+        live_free(s);
+        return -1;
+    }
+    for (size_t i = 0; i < c->n; ++i) {
+        s->player[i].stint_start = -1.0;
+        s->player[i].game = -1;
+        s->player[i].final_projection = pregame[i];
+        if (name_index_put(&s->players, c->player_name[i], (int)i) != 0) { live_free(s); return -1; }
+    }
+    return 0;
+}
+
+static int live_game_add_row(LiveState *s, int g, int i) {
+    LiveGame *lg = &s->game[g];
+    if (lg->n_rows == lg->cap_rows) {
+        int cap = lg->cap_rows ? 2 * lg->cap_rows : 32;
+        int *nr = realloc(lg->rows, (size_t)cap * sizeof(*nr));
+        if (!nr) return -1;
+        lg->rows = nr;
+        lg->cap_rows = cap;
+    }
+    lg->rows[lg->n_rows++] = i;
+    s->player[i].game = g;
+    return 0;
+}
+
+/* Game by id, created on first sight with the slate rows that list it */
+static int live_game(LiveState *s, const char *id) {
+    int g = name_index_find(&s->games, id);
+    if (g >= 0) return g;
+    if (s->n_games == s->cap_games) {
+        int cap = s->cap_games ? 2 * s->cap_games : 16;
+        LiveGame *ng = realloc(s->game, (size_t)cap * sizeof(*ng));
+        if (!ng) return -1;
+        s->game = ng;
+        s->cap_games = cap;
+    }
+    g = s->n_games++;
+    memset(&s->game[g], 0, sizeof(s->game[g]));
+    snprintf(s->game[g].id, NAME_LEN, "%s", id);
+    if (name_index_put(&s->games, id, g) != 0) return -1;
+    for (size_t i = 0; i < s->c->n; ++i)
+        if (s->player[i].game < 0 && strcmp(s->c->game[i], id) == 0 && live_game_add_row(s, g, (int)i) != 0)
+            return -1;
+    return g;
+}
+
+static double live_minutes_played(const LivePlayer *p, double clock) {
+    double stint = p->stint_start >= 0.0 && clock > p->stint_start ? clock - p->stint_start : 0.0;
+    return (p->seconds + stint) / 60.0;
+}
+
+static void live_reproject(LiveState *s, int i) {
+    LivePlayer *p = &s->player[i];
+    double clock = s->game[p->game].clock;
+    double exp_min = s->c->expected_minutes[i];
+    double played = live_minutes_played(p, clock);
+
+    double pre_rate = exp_min > 0.0 ? s->pregame[i] / exp_min : 0.0;
+    double rate = (pre_rate * LIVE_PRIOR_MINUTES + p->points) / (LIVE_PRIOR_MINUTES + played);
+
+    double remaining = REGULATION_SECONDS - clock;
+    remaining = remaining > 0.0 ? remaining / 60.0 : 0.0;
+    double left = exp_min * remaining / (REGULATION_SECONDS / 60.0);
+    left = left < remaining ? left : remaining;
+
+    double pf36 = s->c->fouls_per36[i] > 0.0 ? s->c->fouls_per36[i] : 3.0;
+    double excess = p->fouls - pf36 * played / 36.0 - 1.0;
+    double foul_factor = p->fouls >= FOUL_OUT_LIMIT ? 0.0
+                       : clamp(1.0 - LIVE_FOUL_TROUBLE * (excess > 0.0 ? excess : 0.0), 0.0, 1.0);
+
+    p->final_projection = p->points + rate * left * foul_factor;
+}
+
+/* Apply one event line; returns the slate row it updated, or -1. For a
+ * CLOCK event *clock_game is the game whose active rows were re-projected
+ * (-1 otherwise). */
+static int live_apply(LiveState *s, char *line, int *clock_game) {
+    char *f[5];
+    int nf = csv_split(line, f, 5);
+    *clock_game = -1;
+    if (nf < 4) return -1;
+
+    int g = live_game(s, f[0]);
+    if (g < 0) return -1;
+    double clock = strtod(f[1], NULL);
+    if (clock > s->game[g].clock) s->game[g].clock = clock;
+    if (strcmp(f[3], "CLOCK") == 0) {
+        const LiveGame *lg = &s->game[g];
+        for (int k = 0; k < lg->n_rows; ++k)
+            if (s->player[lg->rows[k]].game == g && s->c->is_out[lg->rows[k]] == 0.0) live_reproject(s, lg->rows[k]);
+        *clock_game = g;
+        return -1;
+    }
+
+    int i = name_index_find(&s->players, f[2]);
+    if (i < 0) return -1;
+    LivePlayer *p = &s->player[i];
+    if (p->game != g && live_game_add_row(s, g, i) != 0) return -1;
+    double value = nf > 4 ? strtod(f[4], NULL) : 0.0;
+
+    if (strcmp(f[3], "PTS") == 0) {
+        p->points += value;
+    } else if (strcmp(f[3], "IN") == 0) {
+        if (p->stint_start < 0.0) p->stint_start = clock;
+    } else if (strcmp(f[3], "OUT") == 0) {
+        if (p->stint_start >= 0.0 && clock > p->stint_start) p->seconds += clock - p->stint_start;
+        p->stint_start = -1.0;
+    } else if (strcmp(f[3], "PF") == 0) {
+        p->fouls++;
+    } else {
+        return -1;
+    }
+    live_reproject(s, i);
+    return i;
+}
+
+static void live_print(const LiveState *s, int i) {
+    const LivePlayer *p = &s->player[i];
+    double clock = s->game[p->game].clock;
+    printf("%-10s %5.0f  %-24s pts %5.1f  min %4.1f  pf %d  final %6.2f  (pregame %.2f)\n",
+           s->game[p->game].id, clock, s->c->player_name[i], p->points,
+           live_minutes_played(p, clock), p->fouls, p->final_projection, s->pregame[i]);
+}
+
+static int cmd_live(int argc, char **argv) {
+    if (argc < 1) { fprintf(stderr, "usage: points_model live <slate.csv> [events.csv|-]\n"); return 2; }
+
+    InputColumns c;
+    OutputColumns o;
+    LiveState s;
+    if (slate_load_csv(argv[0], &c) != 0) return 1;
+    if (output_columns_alloc(&o, c.n) != 0) { columns_free(&c); return 1; }
+    project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+    if (live_init(&s, &c, o.projection) != 0) { output_columns_free(&o); columns_free(&c); return 1; }
+
+    FILE *fp = stdin;
+    if (argc >= 2 && strcmp(argv[1], "-") != 0 && !(fp = fopen(argv[1], "r"))) {
+        perror(argv[1]);
+        live_free(&s);
+        output_columns_free(&o);
+        columns_free(&c);
+        return 1;
+    }
+
+    char line[256];
+    long events = 0;
+    double t0 = now_seconds();
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        ++events;
+        int g, i = live_apply(&s, line, &g);
+        if (i >= 0) live_print(&s, i);
+        for (int k = 0; g >= 0 && k < s.game[g].n_rows; ++k) {
+            int r = s.game[g].rows[k];
+            if (s.player[r].game == g && c.is_out[r] == 0.0) live_print(&s, r);
+        }
+    }
+    double t1 = now_seconds();
+    fprintf(stderr, "processed %ld events in %.3f ms\n", events, (t1 - t0) * 1e3);
+
+    if (fp != stdin) fclose(fp);
+    live_free(&s);
+    output_columns_free(&o);
+    columns_free(&c);
+    return 0;
+}
+
+/*======================== LINE CONSENSUS ========================*/
+
+/* Streaming multi-book aggregation. Updates are CSV lines
+ *
+ *     book,player,line[,over,under]
+ *
+ * and each one replaces that book's latest quote for the player. Per
+ * player we keep the quotes by book plus the same lines in sorted order,
+ * and running weighted sums, so an update is one delete + one insert in
+ * a sorted array of at most BOOKS_MAX entries and the consensus (median,
+ * or weighted mean with --weights) is read off in O(1); nothing is
+ * re-sorted or re-summed per tick. The consensus becomes the row's
+ * player_line_pts and the row is re-projected. When quotes carry prices,
+ * the weighted mean of the books' no-vig P(over) (--devig method) is
+ * kept the same way, under either consensus, and written to mkt_p_over;
+ * it goes back to NAN once no book's current quote is priced. */
+#define BOOKS_MAX 16
+
+typedef enum { CONSENSUS_MEDIAN, CONSENSUS_MEAN } ConsensusKind;
+
+typedef struct {
+    double line[BOOKS_MAX];        /* latest quote by book id; NAN = none */
+    double over[BOOKS_MAX], under[BOOKS_MAX];  /* its prices; NAN = unpriced */
+    double p_over[BOOKS_MAX];      /* no-vig P(over) by book; NAN = unpriced */
+    double sorted[BOOKS_MAX];      /* quoted lines, ascending */
+    int n, n_priced;               /* books quoted / books quoted with prices */
+    double w_sum, w_line;          /* running weighted sums over quoted books */
+    double wp_sum, wp_over;        /* ... over priced books */
+} BookQuotes;
+
+typedef struct {
+    InputColumns *c;
+    BookQuotes *q;                 /* per slate row */
+    NameIndex players, books;
+    double weight[BOOKS_MAX];
+    char book_name[BOOKS_MAX][NAME_LEN];
+    int n_books;
+    ConsensusKind kind;
+} BookState;
+
+static double book_consensus(const BookState *s, const BookQuotes *q) {
+    if (q->n == 0) return NAN;
+    if (s->kind == CONSENSUS_MEAN) return q->w_line / q->w_sum;
+    return q->n & 1 ? q->sorted[q->n / 2] : 0.5 * (q->sorted[q->n / 2 - 1] + q->sorted[q->n / 2]);
+}
+
+static void book_quote(BookState *s, BookQuotes *q, int b, double line, double p_over) {
+    double w = s->weight[b], old = q->line[b];
+    if (!isnan(old)) {
+        int k = 0;
+        while (q->sorted[k] != old) ++k;
+        memmove(&q->sorted[k], &q->sorted[k + 1], (size_t)(q->n - k - 1) * sizeof(double));
+        q->n--;
+        q->w_sum -= w;
+        q->w_line -= w * old;
+    }
+    if (!isnan(q->p_over[b])) {
+        q->n_priced--;
+        q->wp_sum -= w;
+        q->wp_over -= w * q->p_over[b];
+    }
+    int k = q->n++;
+    while (k > 0 && q->sorted[k - 1] > line) { q->sorted[k] = q->sorted[k - 1]; --k; }
+    q->sorted[k] = line;
+    q->w_sum += w;
+    q->w_line += w * line;
+    q->line[b] = line;
+    q->p_over[b] = p_over;
+    if (!isnan(p_over)) {
+        q->n_priced++;
+        q->wp_sum += w;
+        q->wp_over += w * p_over;
+    }
+}
+
+static void books_free(BookState *s) {
+    free(s->q);
+    name_index_free(&s->players);
+    name_index_free(&s->books);
+}
+
+static int books_init(BookState *s, InputColumns *c, ConsensusKind kind) {
+    memset(s, 0, sizeof(*s));
+    s->c = c;
+    s->kind = kind;
+    s->q = malloc((c->n ? c->n : 1) * sizeof(*s->q));
+    if (!s->q || name_index_init(&s->players, c->n) != 0 || name_index_init(&s->books, BOOKS_MAX) != 0) {
+        books_free(s);
+        return -1;
+    }
+    for (size_t i = 0; i < c->n; ++i) {
+        BookQuotes *q = &s->q[i];
+        memset(q, 0, sizeof(*q));
+        for (int b = 0; b < BOOKS_MAX; ++b) q->line[b] = q->over[b] = q->under[b] = q->p_over[b] = NAN;
+        if (name_index_put(&s->players, c->player_name[i], (int)i) != 0) { books_free(s); return -1; }
+    }
+    for (int b = 0; b < BOOKS_MAX; ++b) s->weight[b] = 1.0;
+    return 0;
+}
+
+/* Book id for a name, registering it on first sight; -1 when full */
+static int book_id(BookState *s, const char *name) {
+    int b = name_index_find(&s->books, name);
+    if (b >= 0 || s->n_books == BOOKS_MAX) return b;
+    b = s->n_books++;
+    snprintf(s->book_name[b], NAME_LEN, "%s", name);
+    return name_index_put(&s->books, name, b) == 0 ? b : -1;
+}
+
+/* "pinnacle=3,circa=2" */
+static int books_parse_weights(BookState *s, char *spec) {
+    for (char *tok = strtok(spec, ","); tok; tok = strtok(NULL, ",")) {
+        char *eq = strchr(tok, '=');
+        if (!eq) return -1;
+        *eq = 0;
+        int b = book_id(s, tok);
+        if (b < 0 || (s->weight[b] = atof(eq + 1)) <= 0.0) return -1;
+    }
+    return 0;
+}
+
+/* Book b quotes row i at line (prices may be NAN) */
+static void books_update(BookState *s, int i, int b, double line, double over, double under) {
+    double p_over = NAN;
+    devig_batch(&over, &under, 1, DEVIG_METHOD, &p_over);
+    BookQuotes *q = &s->q[i];
+    book_quote(s, q, b, line, p_over);
+    q->over[b] = over;
+    q->under[b] = under;
+    s->c->player_line_pts[i] = book_consensus(s, q);
+    /* Counted rather than testing wp_sum, which keeps rounding residue
+     * once the last priced book is withdrawn */
+    s->c->market_p_over[i] = q->n_priced ? q->wp_over / q->wp_sum : NAN;
+}
+
+/* Apply one update line; returns the slate row or -1 */
+static int books_apply(BookState *s, char *line) {
+    char *f[5];
+    int nf = csv_split(line, f, 5);
+    if (nf < 3) return -1;
+    int b = book_id(s, f[0]), i = name_index_find(&s->players, f[1]);
+    char *end;
+    double value = strtod(f[2], &end);
+    if (b < 0 || i < 0 || end == f[2] || !isfinite(value)) return -1;
+    books_update(s, i, b, value, nf == 5 ? atof(f[3]) : NAN, nf == 5 ? atof(f[4]) : NAN);
+    return i;
+}
+
+static int cmd_books(int argc, char **argv) {
+    ConsensusKind kind = CONSENSUS_MEDIAN;
+    char *weights = NULL;
+    int quiet = 0;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--quiet") == 0) { quiet = 1; --argc; ++argv; continue; }
+        if (argc < 2) break;
+        if (strcmp(argv[0], "--consensus") == 0)    kind = strcmp(argv[1], "mean") == 0 ? CONSENSUS_MEAN : CONSENSUS_MEDIAN;
+        else if (strcmp(argv[0], "--weights") == 0) weights = argv[1];
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1) {
+        fprintf(stderr, "usage: points_model books [--consensus median|mean] [--weights book=w,...] [--quiet] "
+                        "<slate> [updates.csv|-]\n"
+                        "  --weights weights the mean consensus line and the market P(over); the median line is unweighted\n");
+        return 2;
+    }
+
+    InputColumns c;
+    Snapshot snap;
+    OutputColumns o;
+    BookState s;
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    if (output_columns_alloc(&o, c.n) != 0) { output_columns_free(&o); columns_free(&c); snapshot_close(&snap); return 1; }
+    if (books_init(&s, &c, kind) != 0 || (weights && books_parse_weights(&s, weights) != 0)) {
+        if (weights) fprintf(stderr, "bad --weights '%s'\n", weights);
+        books_free(&s);
+        output_columns_free(&o);
+        columns_free(&c);
+        snapshot_close(&snap);
+        return 1;
+    }
+    project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+
+    FILE *fp = stdin;
+    if (argc >= 2 && strcmp(argv[1], "-") != 0 && !(fp = fopen(argv[1], "r"))) {
+        perror(argv[1]);
+        books_free(&s);
+        output_columns_free(&o);
+        columns_free(&c);
+        snapshot_close(&snap);
+        return 1;
+    }
+
+    char line[256];
+    long updates = 0, moves = 0;
+    double t0 = now_seconds();
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        ++updates;
+        int i = books_apply(&s, line);
+        if (i < 0) continue;
+        double before = o.projection[i];
+        OutputColumns row = { o.base_points + i, o.final_multiplier + i, o.projection + i };
+        project_batch(&c, (size_t)i, (size_t)i + 1, PROFILE_PER_ROW, &row);
+        if (o.projection[i] == before) continue;
+        ++moves;
+        if (!quiet)
+            printf("%-24s consensus %6.2f (%2d books)  mkt P(over) %6.4f  proj %6.2f -> %6.2f\n",
+                   c.player_name[i], c.player_line_pts[i], s.q[i].n, c.market_p_over[i], before, o.projection[i]);
+    }
+    double t1 = now_seconds();
+    fprintf(stderr, "%ld updates (%ld moved a projection) in %.3f ms, %.0f ns/update\n",
+            updates, moves, (t1 - t0) * 1e3, updates ? (t1 - t0) * 1e9 / (double)updates : 0.0);
+
+    if (fp != stdin) fclose(fp);
+    books_free(&s);
+    output_columns_free(&o);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return 0;
+}
+
+/*======================== EDGE SCANNER ========================*/
+
+/* Ranks every (player, book, side) quote by edge = model P(side at that
+ * book's line) - the book's implied probability 1 / decimal price, and
+ * keeps the top K current as quotes stream in (same feed as 'books').
+ * Model probabilities come from model_p_over(), so each book's own line
+ * is priced without resampling.
+ *
+ * Every candidate sits in one of two indexed heaps: a min-heap holding
+ * the K best and a max-heap with the rest. A quote changes the player's
+ * consensus and projection, so its at most 2 x BOOKS_MAX candidates are
+ * re-scored and re-sifted, then the heap tops are swapped while the best
+ * outsider beats the worst insider: O(log N) per candidate, exact, with no
+ * sort of the full candidate set per tick. The slate's own line and
+ * over / under prices, when present, seed a book named "slate". */
+typedef struct {
+    int *v;                        /* candidate ids */
+    size_t n;
+    int max_heap;
+} EdgeHeap;
+
+typedef struct {
+    BookState books;
+    OutputColumns o;
+    double *edge;                  /* per candidate id */
+    unsigned char *where;          /* 0 = inactive, 1 = top, 2 = rest */
+    size_t *pos;                   /* index in its heap */
+    EdgeHeap top, rest;
+    size_t k;
+} EdgeScan;
+
+/* Candidate id = (row * BOOKS_MAX + book) * 2 + side (0 = over, 1 = under) */
+static size_t edge_id(size_t row, int book, int side) { return (row * BOOKS_MAX + (size_t)book) * 2 + (size_t)side; }
+
+static int edge_before(const EdgeScan *e, const EdgeHeap *h, int a, int b) {
+    if (e->edge[a] != e->edge[b]) return h->max_heap ? e->edge[a] > e->edge[b] : e->edge[a] < e->edge[b];
+    return h->max_heap ? a < b : a > b;
+}
+
+static void edge_heap_set(EdgeScan *e, EdgeHeap *h, size_t k, int id) {
+    h->v[k] = id;
+    e->pos[id] = k;
+}
+
+static void edge_heap_sift(EdgeScan *e, EdgeHeap *h, size_t k) {
+    int id = h->v[k];
+    while (k > 0 && edge_before(e, h, id, h->v[(k - 1) / 2])) {
+        edge_heap_set(e, h, k, h->v[(k - 1) / 2]);
+        k = (k - 1) / 2;
+    }
+    for (;;) {
+        size_t l = 2 * k + 1, m = k;
+        int best = id;
+        if (l < h->n && edge_before(e, h, h->v[l], best)) { m = l; best = h->v[l]; }
+        if (l + 1 < h->n && edge_before(e, h, h->v[l + 1], best)) m = l + 1;
+        if (m == k) break;
+        edge_heap_set(e, h, k, h->v[m]);
+        k = m;
+    }
+    edge_heap_set(e, h, k, id);
+}
+
+static void edge_heap_push(EdgeScan *e, EdgeHeap *h, int id) {
+    edge_heap_set(e, h, h->n++, id);
+    edge_heap_sift(e, h, h->n - 1);
+}
+
+static void edge_heap_remove(EdgeScan *e, EdgeHeap *h, int id) {
+    size_t k = e->pos[id];
+    int last = h->v[--h->n];
+    if (k == h->n) return;
+    edge_heap_set(e, h, k, last);
+    edge_heap_sift(e, h, k);
+}
+
+/* Move the boundary until top holds the K best */
+static void edge_rebalance(EdgeScan *e) {
+    while (e->top.n < e->k && e->rest.n > 0) {
+        int id = e->rest.v[0];
+        edge_heap_remove(e, &e->rest, id);
+        edge_heap_push(e, &e->top, id);
+        e->where[id] = 1;
+    }
+    while (e->top.n > e->k) {
+        int id = e->top.v[0];
+        edge_heap_remove(e, &e->top, id);
+        edge_heap_push(e, &e->rest, id);
+        e->where[id] = 2;
+    }
+    while (e->top.n > 0 && e->rest.n > 0 && edge_before(e, &e->rest, e->rest.v[0], e->top.v[0])) {
+        int in = e->rest.v[0], out = e->top.v[0];
+        edge_heap_remove(e, &e->rest, in);
+        edge_heap_remove(e, &e->top, out);
+        edge_heap_push(e, &e->top, in);
+        edge_heap_push(e, &e->rest, out);
+        e->where[in] = 1;
+        e->where[out] = 2;
+    }
+}
+
+/* Re-project row i and re-score its candidates */
+static void edge_refresh_row(EdgeScan *e, size_t i) {
+    const InputColumns *c = e->books.c;
+    const BookQuotes *q = &e->books.q[i];
+    OutputColumns row = { e->o.base_points + i, e->o.final_multiplier + i, e->o.projection + i };
+    project_batch(c, i, i + 1, PROFILE_PER_ROW, &row);
+
+    for (int b = 0; b < e->books.n_books; ++b) {
+        double p = isnan(q->line[b]) ? NAN : model_p_over(c, i, e->o.projection[i], q->line[b]);
+        double price[2] = { q->over[b], q->under[b] }, p_side[2] = { p, 1.0 - p };
+        for (int side = 0; side < 2; ++side) {
+            int id = (int)edge_id(i, b, side);
+            double edge = p_side[side] - 1.0 / price_decimal(price[side]);
+            if (e->where[id]) edge_heap_remove(e, e->where[id] == 1 ? &e->top : &e->rest, id);
+            e->where[id] = 0;
+            if (isnan(edge)) continue;
+            e->edge[id] = edge;
+            e->where[id] = 2;
+            edge_heap_push(e, &e->rest, id);
+        }
+    }
+    edge_rebalance(e);
+}
+
+/* Print the top K best first (sorting only those K) */
+static void edge_print(const EdgeScan *e, long tick) {
+    EdgeHeap order = { malloc((e->top.n ? e->top.n : 1) * sizeof(int)), e->top.n, 1 };
+    if (!order.v) return;
+    memcpy(order.v, e->top.v, e->top.n * sizeof(int));
+    for (size_t a = 1; a < order.n; ++a)
+        for (size_t b = a; b > 0 && edge_before(e, &order, order.v[b], order.v[b - 1]); --b) {
+            int t = order.v[b];
+            order.v[b] = order.v[b - 1];
+            order.v[b - 1] = t;
+        }
+    const int *ids = order.v;
+    const InputColumns *c = e->books.c;
+    printf("-- top %zu after %ld updates --\n", e->top.n, tick);
+    for (size_t r = 0; r < e->top.n; ++r) {
+        size_t id = (size_t)ids[r], i = id / 2 / BOOKS_MAX;
+        int b = (int)(id / 2 % BOOKS_MAX), side = (int)(id % 2);
+        const BookQuotes *q = &e->books.q[i];
+        double price = side ? q->under[b] : q->over[b];
+        printf("%3zu  %-24s %-12s %-5s %6.1f %7g  model %6.4f  implied %6.4f  edge %+7.4f\n", r + 1,
+               c->player_name[i], e->books.book_name[b], side ? "under" : "over", q->line[b], price,
+               e->edge[id] + 1.0 / price_decimal(price), 1.0 / price_decimal(price), e->edge[id]);
+    }
+    free(order.v);
+}
+
+static void edge_scan_free(EdgeScan *e) {
+    books_free(&e->books);
+    output_columns_free(&e->o);
+    free(e->edge);
+    free(e->where);
+    free(e->pos);
+    free(e->top.v);
+    free(e->rest.v);
+}
+
+static int cmd_edges(int argc, char **argv) {
+    size_t k = 20;
+    long every = 0;
+    ConsensusKind kind = CONSENSUS_MEDIAN;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--k") == 0)              k = (size_t)atol(argv[1]);
+        else if (strcmp(argv[0], "--every") == 0)     every = atol(argv[1]);
+        else if (strcmp(argv[0], "--consensus") == 0) kind = strcmp(argv[1], "mean") == 0 ? CONSENSUS_MEAN : CONSENSUS_MEDIAN;
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1 || k == 0) {
+        fprintf(stderr, "usage: points_model edges [--k K] [--every N] [--consensus median|mean] <slate> [quotes.csv|-]\n");
+        return 2;
+    }
+
+    InputColumns c;
+    Snapshot snap;
+    EdgeScan e;
+    memset(&e, 0, sizeof(e));
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    size_t n_cand = c.n * BOOKS_MAX * 2;
+    e.k = k;
+    e.top.max_heap = 0;
+    e.rest.max_heap = 1;
+    e.edge = malloc((n_cand ? n_cand : 1) * sizeof(double));
+    e.where = calloc(n_cand ? n_cand : 1, 1);
+    e.pos = malloc((n_cand ? n_cand : 1) * sizeof(size_t));
+    e.top.v = malloc((n_cand ? n_cand : 1) * sizeof(int));
+    e.rest.v = malloc((n_cand ? n_cand : 1) * sizeof(int));
+    FILE *fp = stdin;
+    if (!e.edge || !e.where || !e.pos || !e.top.v || !e.rest.v || output_columns_alloc(&e.o, c.n) != 0 ||
+        books_init(&e.books, &c, kind) != 0 ||
+        (argc >= 2 && strcmp(argv[1], "-") != 0 && !(fp = fopen(argv[1], "r")))) {
+        if (!fp) perror(argv[1]);
+        edge_scan_free(&e);
+        columns_free(&c);
+        snapshot_close(&snap);
+        return 1;
+    }
+
+    /* Seed from the slate's own quotes, then one full scan */
+    int slate_book = book_id(&e.books, "slate");
+    for (size_t i = 0; i < c.n; ++i)
+        if (isfinite(c.player_line_pts[i]) && isfinite(c.over_price[i]) && isfinite(c.under_price[i]))
+            books_update(&e.books, (int)i, slate_book, c.player_line_pts[i], c.over_price[i], c.under_price[i]);
+    double t0 = now_seconds();
+    for (size_t i = 0; i < c.n; ++i) edge_refresh_row(&e, i);
+    double t1 = now_seconds();
+    fprintf(stderr, "scanned %zu candidates in %.3f ms\n", e.top.n + e.rest.n, (t1 - t0) * 1e3);
+
+    char line[256];
+    long updates = 0;
+    double t_update = 0.0;
+    while (argc >= 2 && fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        double ta = now_seconds();
+        int i = books_apply(&e.books, line);
+        if (i >= 0) edge_refresh_row(&e, (size_t)i);
+        t_update += now_seconds() - ta;
+        if (++updates, every > 0 && updates % every == 0) edge_print(&e, updates);
+    }
+    edge_print(&e, updates);
+    if (updates)
+        fprintf(stderr, "%ld updates, %zu candidates live, %.0f ns/update to keep the top %zu\n", updates,
+                e.top.n + e.rest.n, t_update * 1e9 / (double)updates, k);
+
+    if (fp != stdin) fclose(fp);
+    edge_scan_free(&e);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return 0;
+}
+
+/*======================== DEADLINE SCHEDULER ========================*/
+
+/* Recompute and re-simulation work for a slate, ordered by tip-off.
+ * Each task belongs to one game and is due at that game's tip; pending
+ * tasks wait in a min-heap keyed on (deadline, arrival order), i.e.
+ * earliest-deadline-first. Simulations run in slices of SCHED_SLICE_ROWS
+ * players. After each slice, newly arrived work is admitted, and if the
+ * head of the heap is due before the running task, the running task goes
+ * back on the heap with its progress kept and the urgent one runs. So a
+ * 10:30pm resim yields to a 6:59pm update within one slice.
+ *
+ * 'points_model schedule' replays a stream of "HH:MM[:SS] <game>
+ * <recompute|sim>" updates on a slate clock that advances by the measured
+ * compute time x --scale. It reports every task's finish against its
+ * deadline, plus the misses. --fifo runs the same stream first-come
+ * first-served without preemption, for comparison. Games with no 'tip'
+ * column sort last. */
+#define SCHED_SLICE_ROWS 2
+
+typedef enum { TASK_RECOMPUTE, TASK_SIMULATE } TaskKind;
+
+typedef struct {
+    int game;
+    TaskKind kind;
+    double arrival, deadline;      /* slate clock, seconds after midnight */
+    size_t done;                   /* rows finished, kept across preemption */
+    uint64_t seq;
+    int preempted;
+} SchedTask;
+
+typedef struct {
+    SchedTask *v;
+    size_t n, cap;
+    int fifo;
+} TaskHeap;
+
+static int task_before(const TaskHeap *h, const SchedTask *a, const SchedTask *b) {
+    if (!h->fifo && a->deadline != b->deadline) return a->deadline < b->deadline;
+    return a->seq < b->seq;
+}
+
+static int task_heap_push(TaskHeap *h, SchedTask t) {
+    if (h->n == h->cap) {
+        size_t cap = h->cap ? 2 * h->cap : 64;
+        SchedTask *v = realloc(h->v, cap * sizeof(*v));
+        if (!v) return -1;
+        h->v = v;
+        h->cap = cap;
+    }
+    size_t i = h->n++;
+    while (i > 0 && task_before(h, &t, &h->v[(i - 1) / 2])) {
+        h->v[i] = h->v[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->v[i] = t;
+    return 0;
+}
+
+static SchedTask task_heap_pop(TaskHeap *h) {
+    SchedTask top = h->v[0], last = h->v[--h->n];
+    size_t i = 0;
+    for (;;) {
+        size_t l = 2 * i + 1, m = i;
+        const SchedTask *best = &last;
+        if (l < h->n && task_before(h, &h->v[l], best)) { m = l; best = &h->v[l]; }
+        if (l + 1 < h->n && task_before(h, &h->v[l + 1], best)) m = l + 1;
+        if (m == i) break;
+        h->v[i] = h->v[m];
+        i = m;
+    }
+    if (h->n > 0) h->v[i] = last;
+    return top;
+}
+
+/* "19:30", "19:30:05" -> seconds after midnight; -1 if malformed */
+static double clock_parse(const char *s) {
+    int hh, mm, ss = 0;
+    if (sscanf(s, "%d:%d:%d", &hh, &mm, &ss) < 2) return -1.0;
+    return hh * 3600.0 + mm * 60.0 + ss;
+}
+
+static void clock_format(double t, char *buf, size_t len) {
+    if (!isfinite(t)) { snprintf(buf, len, "--:--:--"); return; }
+    long s = (long)floor(t);
+    snprintf(buf, len, "%02ld:%02ld:%02ld", s / 3600, s / 60 % 60, s % 60);
+}
+
+typedef struct {
+    double at;
+    int game;
+    TaskKind kind;
+} SchedEvent;
+
+static int cmd_schedule(int argc, char **argv) {
+    int n_sims = 20000, fifo = 0;
+    double scale = 1.0;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--fifo") == 0) { fifo = 1; --argc; ++argv; continue; }
+        if (argc < 2) break;
+        if (strcmp(argv[0], "--n") == 0)          n_sims = atoi(argv[1]);
+        else if (strcmp(argv[0], "--scale") == 0) scale = atof(argv[1]);
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 2 || n_sims <= 0 || scale <= 0.0) {
+        fprintf(stderr, "usage: points_model schedule [--fifo] [--n sims] [--scale S] <slate.csv> <updates|->\n");
+        return 2;
+    }
+
+    InputColumns c;
+    OutputColumns o;
+    if (slate_load_csv(argv[0], &c) != 0) return 1;
+    SimResult *sim = calloc(c.n ? c.n : 1, sizeof(*sim));
+    size_t *start = calloc(c.n_games + 1, sizeof(*start));
+    size_t *rows = malloc((c.n ? c.n : 1) * sizeof(*rows));
+    double *tip = malloc((c.n_games ? c.n_games : 1) * sizeof(*tip));
+    const char **game_name = calloc(c.n_games ? c.n_games : 1, sizeof(*game_name));
+    SchedEvent *ev = NULL;
+    size_t n_ev = 0, cap_ev = 0;
+    TaskHeap heap = { NULL, 0, 0, fifo };
+    NameIndex ix;
+    int rc = 0;
+    if (!sim || !start || !rows || !tip || !game_name || output_columns_alloc(&o, c.n) != 0 ||
+        name_index_init(&ix, c.n_games) != 0) {
+        free(sim); free(start); free(rows); free(tip); free(game_name);
+        output_columns_free(&o);
+        columns_free(&c);
+        return 1;
+    }
+
+    /* Rows of each game (CSR) and each game's tip-off from its first row */
+    for (size_t i = 0; i < c.n; ++i) start[c.game_idx[i] + 1]++;
+    for (size_t g = 0; g < c.n_games; ++g) start[g + 1] += start[g];
+    for (size_t g = 0; g < c.n_games; ++g) tip[g] = INFINITY;
+    {
+        size_t *fill = calloc(c.n_games ? c.n_games : 1, sizeof(*fill));
+        if (!fill) rc = 1;
+        for (size_t i = 0; fill && rc == 0 && i < c.n; ++i) {
+            int g = c.game_idx[i];
+            if (fill[g] == 0) {
+                game_name[g] = c.game[i][0] ? c.game[i] : c.player_name[i];
+                if (!isnan(c.tipoff[i]))
+                    tip[g] = floor(c.tipoff[i] / 100.0) * 3600.0 + fmod(c.tipoff[i], 100.0) * 60.0;
+                if (c.game[i][0] && name_index_find(&ix, c.game[i]) < 0 && name_index_put(&ix, c.game[i], g) != 0)
+                    rc = 1;
+            }
+            rows[start[g] + fill[g]++] = i;
+        }
+        free(fill);
+    }
+    if (rc == 0) project_batch(&c, 0, c.n, PROFILE_PER_ROW, &o);
+
+    FILE *fp = stdin;
+    if (rc == 0 && strcmp(argv[1], "-") != 0 && !(fp = fopen(argv[1], "r"))) { perror(argv[1]); rc = 1; }
+    char line[256];
+    while (rc == 0 && fgets(line, sizeof(line), fp)) {
+        char at[32], game[NAME_LEN * 2], kind[32];
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (sscanf(line, "%31s %63s %31s", at, game, kind) != 3) continue;
+        int g = name_index_find(&ix, game);
+        double t = clock_parse(at);
+        if (g < 0 || t < 0.0 || (strcmp(kind, "sim") != 0 && strcmp(kind, "recompute") != 0)) {
+            fprintf(stderr, "skipping update: %s", line);
+            continue;
+        }
+        if (n_ev == cap_ev) {
+            cap_ev = cap_ev ? 2 * cap_ev : 64;
+            SchedEvent *p = realloc(ev, cap_ev * sizeof(*p));
+            if (!p) { rc = 1; break; }
+            ev = p;
+        }
+        ev[n_ev++] = (SchedEvent){ t, g, strcmp(kind, "sim") == 0 ? TASK_SIMULATE : TASK_RECOMPUTE };
+    }
+    if (fp && fp != stdin) fclose(fp);
+    for (size_t k = 1; k < n_ev; ++k)
+        if (ev[k].at < ev[k - 1].at) { fprintf(stderr, "updates must be in clock order\n"); rc = 1; break; }
+
+    printf("%-16s %-9s %8s %8s %8s %9s %5s\n", "game", "task", "arrived", "due", "done", "slack_s", "preempt");
+    size_t next_ev = 0, misses = 0, preemptions = 0, finished = 0;
+    double clock = n_ev ? ev[0].at : 0.0, worst = 0.0;
+    SchedTask cur;
+    int running = 0;
+    uint64_t seq = 0;
+    while (rc == 0 && (next_ev < n_ev || heap.n > 0 || running)) {
+        for (; next_ev < n_ev && ev[next_ev].at <= clock; ++next_ev) {
+            SchedTask t = { ev[next_ev].game, ev[next_ev].kind, ev[next_ev].at, tip[ev[next_ev].game], 0, seq++, 0 };
+            if (task_heap_push(&heap, t) != 0) { rc = 1; break; }
+        }
+        if (!running) {
+            if (heap.n == 0) { clock = ev[next_ev].at; continue; }
+            cur = task_heap_pop(&heap);
+            running = 1;
+        }
+
+        /* One slice of the running task */
+        size_t g0 = start[cur.game], n_rows = start[cur.game + 1] - g0;
+        double t0 = now_seconds();
+        if (cur.kind == TASK_RECOMPUTE) {
+            for (size_t k = 0; k < n_rows; ++k) {
+                size_t i = rows[g0 + k];
+                OutputColumns one = { o.base_points + i, o.final_multiplier + i, o.projection + i };
+                project_batch(&c, i, i + 1, PROFILE_PER_ROW, &one);
+            }
+            cur.done = n_rows;
+        } else {
+            size_t end = cur.done + SCHED_SLICE_ROWS < n_rows ? cur.done + SCHED_SLICE_ROWS : n_rows;
+            for (; cur.done < end; ++cur.done) {
+                size_t i = rows[g0 + cur.done];
+                simulate_batch(&c, o.projection + i, i, i + 1, n_sims, 1, sim + i);
+            }
+        }
+        clock += (now_seconds() - t0) * scale;
+
+        if (cur.done == n_rows) {
+            char a[32], d[32], f[32];
+            clock_format(cur.arrival, a, sizeof(a));
+            clock_format(cur.deadline, d, sizeof(d));
+            clock_format(clock, f, sizeof(f));
+            double slack = cur.deadline - clock;
+            printf("%-16s %-9s %8s %8s %8s %9.1f %5d%s\n", game_name[cur.game],
+                   cur.kind == TASK_SIMULATE ? "sim" : "recompute", a, d, f,
+                   isfinite(slack) ? slack : 0.0, cur.preempted, slack < 0.0 ? "  MISSED" : "");
+            if (slack < 0.0) { ++misses; if (-slack > worst) worst = -slack; }
+            ++finished;
+            running = 0;
+            continue;
+        }
+        if (fifo) continue;
+        for (; next_ev < n_ev && ev[next_ev].at <= clock; ++next_ev) {
+            SchedTask t = { ev[next_ev].game, ev[next_ev].kind, ev[next_ev].at, tip[ev[next_ev].game], 0, seq++, 0 };
+            if (task_heap_push(&heap, t) != 0) { rc = 1; break; }
+        }
+        if (heap.n > 0 && task_before(&heap, &heap.v[0], &cur)) {
+            cur.preempted++;
+            ++preemptions;
+            if (task_heap_push(&heap, cur) != 0) rc = 1;
+            running = 0;
+        }
+    }
+    fprintf(stderr, "%s: %zu tasks, %zu deadline misses (worst %.1f s late), %zu preemptions\n",
+            fifo ? "fifo" : "edf", finished, misses, worst, preemptions);
+
+    name_index_free(&ix);
+    free(heap.v);
+    free(ev);
+    free(sim); free(start); free(rows); free(tip); free(game_name);
+    output_columns_free(&o);
+    columns_free(&c);
+    return rc;
+}
+
+/*======================== PROJECTION SERVICE ========================*/
+
+/* 'points_model serve' answers single-player requests over a Unix socket.
+ * Each connection sends a slate header line, then one slate row per
+ * request; each row is answered with "<name> <projection>", in order.
+ *
+ * Requests are coalesced into batches for project_batch(). The batcher
+ * keeps a decayed estimate of the arrival rate and the kernel's cost per
+ * row, and flushes the pending batch when any of these holds:
+ *   - it is full (--max-batch);
+ *   - waiting longer would push the oldest request past --budget-us once
+ *     the kernel's own time is counted;
+ *   - fewer than one more arrival is expected before that point (idle:
+ *     flush at once rather than wait for nobody);
+ *   - it has reached the size the current rate fills in the remaining
+ *     window, rounded up to SERVE_LANES rows.
+ * So at low load every request goes out alone with no added wait, and
+ * under load batches grow toward the latency budget. The whole service
+ * is one poll() loop, so the kernel runs with no locking. Answers are
+ * sent without blocking: what a slow reader cannot take yet stays in its
+ * output buffer until poll() reports it writable, and a client more than
+ * SERVE_OUT_MAX behind is dropped, so no reader stalls the others. */
+#define SERVE_MAX_CLIENTS 256
+#define SERVE_LANES       8        /* batch sizes rounded to whole vector widths */
+#define SERVE_RATE_TAU    0.1      /* seconds, arrival-rate decay */
+#define SERVE_BUF         8192
+#define SERVE_OUT_MAX     (1u << 20)   /* unsent answer bytes before a client is dropped */
+#define SERVE_DRAIN       1.0          /* seconds to flush answers at shutdown */
+#define SERVE_LAT_BINS    4096     /* latency histogram, 10 us bins */
+
+typedef struct {
+    int fd;                        /* -1 free */
+    unsigned gen;                  /* bumped on reuse, so late answers are dropped */
+    int have_header;
+    SlateHeader hdr;
+    char in[SERVE_BUF];
+    size_t in_len;
+    char *out;
+    size_t out_len, out_cap;
+} ServeClient;
+
+typedef struct {
+    double budget;                 /* seconds, arrival to answer */
+    size_t max_batch;
+
+    InputColumns c;                /* pending requests */
+    OutputColumns o;
+    int *client;
+    unsigned *gen;
+    double *arrival;
+
+    double rate, rate_at;          /* decayed arrivals/s as of rate_at */
+    double cost_row;               /* EWMA kernel seconds per row */
+
+    size_t requests, batches;
+    unsigned lat_hist[SERVE_LAT_BINS];
+} MicroBatcher;
+
+static volatile sig_atomic_t SERVE_STOP;
+
+static void serve_on_signal(int sig) {
+    (void)sig;
+    SERVE_STOP = 1;
+}
+
+static double batcher_rate(const MicroBatcher *b, double now) {
+    return b->rate * exp(-(now - b->rate_at) / SERVE_RATE_TAU);
+}
+
+static void batcher_arrival(MicroBatcher *b, double now) {
+    b->rate = batcher_rate(b, now) + 1.0 / SERVE_RATE_TAU;
+    b->rate_at = now;
+}
+
+/* Seconds until the pending batch must go: 0 = now, <0 = nothing pending */
+static double batcher_wait(const MicroBatcher *b, double now) {
+    size_t n = b->c.n;
+    if (n == 0) return -1.0;
+    if (n >= b->max_batch) return 0.0;
+
+    double left = b->arrival[0] + b->budget - b->cost_row * (double)n - now;
+    double rate = batcher_rate(b, now);
+    if (left <= 0.0 || rate * left < 1.0) return 0.0;
+
+    size_t target = (size_t)(rate * (left + (now - b->arrival[0])));
+    target = (target + SERVE_LANES - 1) / SERVE_LANES * SERVE_LANES;
+    if (target > b->max_batch) target = b->max_batch;
+    if (n >= target) return 0.0;
+    double fill = (double)(target - n) / rate;
+    return fill < left ? fill : left;
+}
+
+static void serve_client_drop(ServeClient *cl) {
+    close(cl->fd);
+    cl->fd = -1;
+    cl->out_len = 0;
+}
+
+/* Send what the socket takes now and keep the rest; -1 = drop the client */
+static int serve_client_write(ServeClient *cl) {
+    size_t off = 0;
+    while (off < cl->out_len) {
+        ssize_t w = send(cl->fd, cl->out + off, cl->out_len - off, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (w <= 0) return -1;     /* peer gone */
+        off += (size_t)w;
+    }
+    cl->out_len -= off;
+    memmove(cl->out, cl->out + off, cl->out_len);
+    return cl->out_len > SERVE_OUT_MAX ? -1 : 0;
+}
+
+static void batcher_flush(MicroBatcher *b, ServeClient *clients) {
+    size_t n = b->c.n;
+    if (n == 0) return;
+    double t0 = now_seconds();
+    if (games_prepare(&b->c) == 0) project_batch(&b->c, 0, n, PROFILE_PER_ROW, &b->o);
+    double t1 = now_seconds();
+    b->cost_row = 0.9 * b->cost_row + 0.1 * (t1 - t0) / (double)n;
+
+    for (size_t i = 0; i < n; ++i) {
+        ServeClient *cl = &clients[b->client[i]];
+        if (cl->fd < 0 || cl->gen != b->gen[i]) continue;
+        if (cl->out_cap - cl->out_len < NAME_LEN + 32) {
+            size_t cap = cl->out_cap ? 2 * cl->out_cap : 4096;
+            char *p = realloc(cl->out, cap);
+            if (!p) continue;
+            cl->out = p;
+            cl->out_cap = cap;
+        }
+        cl->out_len += (size_t)snprintf(cl->out + cl->out_len, cl->out_cap - cl->out_len, "%s %.2f\n",
+                                        b->c.player_name[i], b->o.projection[i]);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        ServeClient *cl = &clients[b->client[i]];
+        if (cl->fd >= 0 && cl->out_len && serve_client_write(cl) != 0) serve_client_drop(cl);
+    }
+
+    double done = now_seconds();
+    for (size_t i = 0; i < n; ++i) {
+        size_t bin = (size_t)((done - b->arrival[i]) * 1e5);
+        b->lat_hist[bin < SERVE_LAT_BINS ? bin : SERVE_LAT_BINS - 1]++;
+    }
+    b->requests += n;
+    b->batches++;
+    b->c.n = 0;
+}
+
+static double serve_lat_quantile(const MicroBatcher *b, double q) {
+    double target = q * (double)b->requests, acc = 0.0;
+    for (int k = 0; k < SERVE_LAT_BINS; ++k)
+        if ((acc += b->lat_hist[k]) >= target) return (k + 1) * 10.0;
+    return SERVE_LAT_BINS * 10.0;
+}
+
+/* Consume complete lines from a client; returns -1 to drop it */
+static int serve_client_read(ServeClient *cl, int k, MicroBatcher *b, ServeClient *clients) {
+    ssize_t r = read(cl->fd, cl->in + cl->in_len, sizeof(cl->in) - 1 - cl->in_len);
+    if (r < 0 && errno == EINTR) return 0;
+    if (r <= 0) return -1;
+    cl->in_len += (size_t)r;
+    cl->in[cl->in_len] = 0;
+
+    char *line = cl->in, *nl;
+    while ((nl = strchr(line, '\n'))) {
+        *nl = 0;
+        if (!cl->have_header) {
+            if (slate_header_parse(line, &cl->hdr, "serve") != 0) {
+                const char msg[] = "error: header needs a 'name' column\n";
+                send(cl->fd, msg, sizeof(msg) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+                return -1;
+            }
+            cl->have_header = 1;
+        } else if (line[0] && line[0] != '\r') {
+            if (b->c.n == b->max_batch) batcher_flush(b, clients);
+            double now = now_seconds();
+            size_t i = b->c.n++;
+            slate_parse_row(&b->c, i, line, &cl->hdr);
+            b->client[i] = k;
+            b->gen[i] = cl->gen;
+            b->arrival[i] = now;
+            batcher_arrival(b, now);
+        }
+        line = nl + 1;
+    }
+    cl->in_len -= (size_t)(line - cl->in);
+    memmove(cl->in, line, cl->in_len);
+    if (cl->in_len == sizeof(cl->in) - 1) return -1;     /* line too long */
+    return 0;
+}
+
+static int cmd_serve(int argc, char **argv) {
+    const char *path = "/tmp/points_model.sock";
+    double budget_us = 2000.0;
+    long max_batch = 1024, stop_after = 0;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--socket") == 0)         path = argv[1];
+        else if (strcmp(argv[0], "--budget-us") == 0) budget_us = atof(argv[1]);
+        else if (strcmp(argv[0], "--max-batch") == 0) max_batch = atol(argv[1]);
+        else if (strcmp(argv[0], "--requests") == 0) stop_after = atol(argv[1]);
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc > 0 || budget_us <= 0.0 || max_batch < 1) {
+        fprintf(stderr, "usage: points_model serve [--socket path] [--budget-us U] [--max-batch N] [--requests N]\n");
+        return 2;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) { fprintf(stderr, "%s: socket path too long\n", path); return 1; }
+    strcpy(addr.sun_path, path);
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (lfd < 0 || bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(lfd, 64) != 0) {
+        perror(path);
+        if (lfd >= 0) close(lfd);
+        return 1;
+    }
+
+    MicroBatcher b;
+    memset(&b, 0, sizeof(b));
+    b.budget = budget_us * 1e-6;
+    b.max_batch = (size_t)max_batch;
+    b.cost_row = 1e-7;
+    b.client = calloc(b.max_batch, sizeof(*b.client));
+    b.gen = calloc(b.max_batch, sizeof(*b.gen));
+    b.arrival = calloc(b.max_batch, sizeof(*b.arrival));
+    ServeClient *clients = calloc(SERVE_MAX_CLIENTS, sizeof(*clients));
+    struct pollfd *pfd = calloc(SERVE_MAX_CLIENTS + 1, sizeof(*pfd));
+    int *pfd_client = calloc(SERVE_MAX_CLIENTS + 1, sizeof(*pfd_client));
+    int rc = 0;
+    if (!b.client || !b.gen || !b.arrival || !clients || !pfd || !pfd_client ||
+        columns_alloc(&b.c, b.max_batch) != 0 || output_columns_alloc(&b.o, b.max_batch) != 0) rc = 1;
+    for (int k = 0; clients && k < SERVE_MAX_CLIENTS; ++k) clients[k].fd = -1;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = serve_on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    if (rc == 0) fprintf(stderr, "serving on %s (budget %.0f us, max batch %zu)\n", path, budget_us, b.max_batch);
+
+    while (rc == 0 && !SERVE_STOP && (stop_after == 0 || b.requests < (size_t)stop_after)) {
+        double wait = batcher_wait(&b, now_seconds());
+        if (wait == 0.0) { batcher_flush(&b, clients); continue; }
+
+        int n = 0;
+        pfd[n++] = (struct pollfd){ lfd, POLLIN, 0 };
+        for (int k = 0; k < SERVE_MAX_CLIENTS; ++k)
+            if (clients[k].fd >= 0) {
+                pfd_client[n] = k;
+                pfd[n++] = (struct pollfd){ clients[k].fd, (short)(POLLIN | (clients[k].out_len ? POLLOUT : 0)), 0 };
+            }
+        struct timespec ts = { (time_t)wait, (long)((wait - floor(wait)) * 1e9) };
+        int ready = ppoll(pfd, (nfds_t)n, wait < 0.0 ? NULL : &ts, NULL);
+        if (ready < 0 && errno != EINTR) { perror("poll"); rc = 1; }
+        if (ready <= 0) continue;
+
+        if (pfd[0].revents & POLLIN) {
+            int fd = accept(lfd, NULL, NULL);
+            int k = 0;
+            while (fd >= 0 && k < SERVE_MAX_CLIENTS && clients[k].fd >= 0) ++k;
+            if (fd >= 0 && k == SERVE_MAX_CLIENTS) close(fd);
+            else if (fd >= 0) {
+                ServeClient *cl = &clients[k];
+                cl->fd = fd;
+                cl->gen++;
+                cl->have_header = 0;
+                cl->in_len = cl->out_len = 0;
+            }
+        }
+        for (int j = 1; j < n; ++j) {
+            int k = pfd_client[j];
+            if (!pfd[j].revents || clients[k].fd < 0) continue;
+            if ((pfd[j].revents & POLLOUT) && serve_client_write(&clients[k]) != 0) {
+                serve_client_drop(&clients[k]);
+                continue;
+            }
+            if ((pfd[j].revents & ~POLLOUT) && serve_client_read(&clients[k], k, &b, clients) != 0)
+                serve_client_drop(&clients[k]);
+        }
+    }
+    batcher_flush(&b, clients);
+
+    if (b.requests > 0)
+        fprintf(stderr, "%zu requests in %zu batches (mean %.1f), latency p50 %.0f us, p99 %.0f us\n",
+                b.requests, b.batches, (double)b.requests / (double)b.batches,
+                serve_lat_quantile(&b, 0.50), serve_lat_quantile(&b, 0.99));
+
+    /* Shutting down: drain queued answers for up to SERVE_DRAIN seconds */
+    double drain_until = now_seconds() + SERVE_DRAIN;
+    for (int k = 0; clients && k < SERVE_MAX_CLIENTS; ++k) {
+        ServeClient *cl = &clients[k];
+        while (cl->fd >= 0 && cl->out_len && now_seconds() < drain_until) {
+            struct pollfd q = { cl->fd, POLLOUT, 0 };
+            if ((poll(&q, 1, 100) < 0 && errno != EINTR) || serve_client_write(cl) != 0) break;
+        }
+        if (cl->fd >= 0) close(cl->fd);
+        free(cl->out);
+    }
+    close(lfd);
+    unlink(path);
+    columns_free(&b.c);
+    output_columns_free(&b.o);
+    free(b.client);
+    free(b.gen);
+    free(b.arrival);
+    free(clients);
+    free(pfd);
+    free(pfd_client);
+    return rc;
+}
+
+/*======================== BULK INGEST ========================*/
+
+/* Backfill of many slate-format CSV files (daily lines, box scores, ...)
+ * into one snapshot store. A reader thread keeps up to INGEST_SLOTS file
+ * reads in flight through io_uring, each into one of a pool of registered
+ * buffers (READ_FIXED), and hands completed buffers to the parser threads,
+ * which parse them in place and give the buffer back. Without io_uring
+ * (old kernel, seccomp, or --no-uring) the reader fills the same buffers
+ * with blocking reads, so parsing is unchanged; if the buffers cannot be
+ * registered (RLIMIT_MEMLOCK) plain io_uring reads are used. Files larger
+ * than a buffer are read blocking into the heap. Every file is parsed into
+ * its own columns (with its own header) and results are joined in argument
+ * order, so the store is the same for any thread count or completion order. */
+#define INGEST_SLOTS    16
+#define INGEST_BUF_SIZE (1u << 20)
+
+typedef struct {
+    int fd;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    unsigned sq_entries;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ptr, *cq_ptr;
+    size_t sq_len, cq_len, sqe_len;
+} Uring;
+
+static void uring_free(Uring *r) {
+    if (r->sqes) munmap(r->sqes, r->sqe_len);
+    if (r->cq_ptr && r->cq_ptr != r->sq_ptr) munmap(r->cq_ptr, r->cq_len);
+    if (r->sq_ptr) munmap(r->sq_ptr, r->sq_len);
+    if (r->fd >= 0) close(r->fd);
+    memset(r, 0, sizeof(*r));
+    r->fd = -1;
+}
+
+static int uring_init(Uring *r, unsigned entries) {
+    struct io_uring_params p;
+    memset(r, 0, sizeof(*r));
+    memset(&p, 0, sizeof(p));
+    r->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (r->fd < 0) return -1;
+
+    r->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (r->cq_len > r->sq_len) r->sq_len = r->cq_len;
+        r->cq_len = r->sq_len;
+    }
+    r->sq_ptr = mmap(NULL, r->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_ptr == MAP_FAILED) { r->sq_ptr = NULL; uring_free(r); return -1; }
+    r->cq_ptr = (p.features & IORING_FEAT_SINGLE_MMAP) ? r->sq_ptr
+              : mmap(NULL, r->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+    if (r->cq_ptr == MAP_FAILED) { r->cq_ptr = NULL; uring_free(r); return -1; }
+    r->sqe_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqe_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) { r->sqes = NULL; uring_free(r); return -1; }
+
+    char *sq = r->sq_ptr, *cq = r->cq_ptr;
+    r->sq_head  = (unsigned *)(sq + p.sq_off.head);
+    r->sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    r->sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *)(sq + p.sq_off.array);
+    r->cq_head  = (unsigned *)(cq + p.cq_off.head);
+    r->cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    r->cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    r->cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    r->sq_entries = p.sq_entries;
+    return 0;
+}
+
+/* Queue a read of len bytes at off; buf_index >= 0 uses that registered buffer */
+static int uring_queue_read(Uring *r, int fd, char *buf, size_t len, size_t off, int buf_index, uint64_t user) {
+    unsigned tail = *r->sq_tail;
+    if (tail - __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE) >= r->sq_entries) return -1;
+    unsigned idx = tail & *r->sq_mask;
+    struct io_uring_sqe *sqe = &r->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = buf_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->off = off;
+    sqe->buf_index = (uint16_t)(buf_index >= 0 ? buf_index : 0);
+    sqe->user_data = user;
+    r->sq_array[idx] = idx;
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int uring_enter(Uring *r, unsigned to_submit, unsigned min_complete) {
+    for (;;) {
+        long rc = syscall(__NR_io_uring_enter, r->fd, to_submit, min_complete,
+                          min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (rc >= 0 || errno != EINTR) return rc < 0 ? -1 : 0;
+    }
+}
+
+static int uring_reap(Uring *r, uint64_t *user, int *res) {
+    unsigned head = *r->cq_head;
+    if (head == __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)) return 0;
+    const struct io_uring_cqe *e = &r->cqes[head & *r->cq_mask];
+    *user = e->user_data;
+    *res = e->res;
+    __atomic_store_n(r->cq_head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/* Bounded queue of slot indices, shared by reader and parsers */
+typedef struct {
+    int items[INGEST_SLOTS];
+    int head, count, closed;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+} SlotQueue;
+
+static void slot_queue_init(SlotQueue *q) {
+    memset(q, 0, sizeof(*q));
+    pthread_mutex_init(&q->mu, NULL);
+    pthread_cond_init(&q->cv, NULL);
+}
+
+static void slot_queue_free(SlotQueue *q) {
+    pthread_mutex_destroy(&q->mu);
+    pthread_cond_destroy(&q->cv);
+}
+
+static void slot_queue_push(SlotQueue *q, int k) {
+    pthread_mutex_lock(&q->mu);
+    q->items[(q->head + q->count++) % INGEST_SLOTS] = k;
+    pthread_cond_signal(&q->cv);
+    pthread_mutex_unlock(&q->mu);
+}
+
+/* Next slot; -1 if closed and empty, or (block == 0) if nothing is ready */
+static int slot_queue_pop(SlotQueue *q, int block) {
+    pthread_mutex_lock(&q->mu);
+    while (block && q->count == 0 && !q->closed) pthread_cond_wait(&q->cv, &q->mu);
+    int k = -1;
+    if (q->count > 0) {
+        k = q->items[q->head];
+        q->head = (q->head + 1) % INGEST_SLOTS;
+        q->count--;
+    }
+    pthread_mutex_unlock(&q->mu);
+    return k;
+}
+
+static void slot_queue_close(SlotQueue *q) {
+    pthread_mutex_lock(&q->mu);
+    q->closed = 1;
+    pthread_cond_broadcast(&q->cv);
+    pthread_mutex_unlock(&q->mu);
+}
+
+typedef struct {
+    char *buf;                     /* registered, INGEST_BUF_SIZE + 1 for the terminator */
+    char *heap;                    /* oversized file read blocking instead */
+    int file, fd;
+    size_t len, done;
+} IngestSlot;
+
+typedef struct {
+    char **paths;
+    int n_files;
+    IngestSlot slots[INGEST_SLOTS];
+    SlotQueue free_q, ready_q;
+    InputColumns *files;           /* [n_files] parsed results */
+    int *file_ok;
+    size_t bytes;
+} Ingest;
+
+/* Parse a whole in-memory slate file (NUL-terminated, modified in place) */
+static int slate_parse_buffer(char *buf, const char *path, InputColumns *c) {
+    SlateHeader h;
+    char *line = buf, *nl = strchr(line, '\n');
+    if (nl) *nl = 0;
+    if (!*line || slate_header_parse(line, &h, path) != 0) {
+        if (!*line) fprintf(stderr, "%s: empty file\n", path);
+        return -1;
+    }
+    if (columns_alloc(c, 256) != 0) return -1;
+    while (nl) {
+        line = nl + 1;
+        if ((nl = strchr(line, '\n'))) *nl = 0;
+        if (line[0] == 0 || line[0] == '\r' || line[0] == '#') continue;
+        if (c->n == c->cap && columns_grow(c) != 0) return -1;
+        slate_parse_row(c, c->n++, line, &h);
+    }
+    market_prepare(c, 0, c->n);
+    return 0;
+}
+
+static void *ingest_parser(void *arg) {
+    Ingest *g = arg;
+    int k;
+    while ((k = slot_queue_pop(&g->ready_q, 1)) >= 0) {
+        IngestSlot *s = &g->slots[k];
+        char *buf = s->heap ? s->heap : s->buf;
+        buf[s->done] = 0;
+        g->file_ok[s->file] = slate_parse_buffer(buf, g->paths[s->file], &g->files[s->file]) == 0;
+        close(s->fd);
+        free(s->heap);
+        s->heap = NULL;
+        slot_queue_push(&g->free_q, k);
+    }
+    return NULL;
+}
+
+static int read_full(int fd, char *buf, size_t len, size_t *got) {
+    *got = 0;
+    while (*got < len) {
+        ssize_t r = read(fd, buf + *got, len - *got);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) return -1;
+        if (r == 0) break;
+        *got += (size_t)r;
+    }
+    return 0;
+}
+
+/* Reader loop: open files into free slots, read them (io_uring if r, else
+ * blocking) and pass full buffers to the parsers. */
+static void ingest_read(Ingest *g, Uring *r, int fixed) {
+    int next = 0, in_flight = 0;
+    unsigned to_submit = 0;
+    while (next < g->n_files || in_flight > 0) {
+        int k;
+        while (next < g->n_files && (k = slot_queue_pop(&g->free_q, in_flight == 0)) >= 0) {
+            IngestSlot *s = &g->slots[k];
+            struct stat st;
+            s->file = next++;
+            s->done = 0;
+            s->fd = open(g->paths[s->file], O_RDONLY);
+            if (s->fd < 0 || fstat(s->fd, &st) != 0) {
+                perror(g->paths[s->file]);
+                if (s->fd >= 0) close(s->fd);
+                slot_queue_push(&g->free_q, k);
+                continue;
+            }
+            s->len = (size_t)st.st_size;
+            g->bytes += s->len;
+            if (r && s->len > 0 && s->len <= INGEST_BUF_SIZE &&
+                uring_queue_read(r, s->fd, s->buf, s->len, 0, fixed ? k : -1, (uint64_t)k) == 0) {
+                ++to_submit;
+                ++in_flight;
+                continue;
+            }
+            char *dst = s->buf;
+            if (s->len > INGEST_BUF_SIZE && !(dst = s->heap = malloc(s->len + 1))) {
+                fprintf(stderr, "%s: out of memory\n", g->paths[s->file]);
+                close(s->fd);
+                slot_queue_push(&g->free_q, k);
+                continue;
+            }
+            if (read_full(s->fd, dst, s->len, &s->done) != 0) perror(g->paths[s->file]);
+            slot_queue_push(&g->ready_q, k);
+        }
+        if (!r || in_flight == 0) continue;
+
+        if (uring_enter(r, to_submit, 1) != 0) { perror("io_uring_enter"); break; }
+        to_submit = 0;
+        uint64_t user;
+        int res;
+        while (uring_reap(r, &user, &res)) {
+            IngestSlot *s = &g->slots[user];
+            if (res > 0) s->done += (size_t)res;
+            if (res > 0 && s->done < s->len &&
+                uring_queue_read(r, s->fd, s->buf + s->done, s->len - s->done, s->done,
+                                 fixed ? (int)user : -1, user) == 0) {
+                ++to_submit;          /* short read: continue where it stopped */
+                continue;
+            }
+            if (res < 0) fprintf(stderr, "%s: %s\n", g->paths[s->file], strerror(-res));
+            --in_flight;
+            slot_queue_push(&g->ready_q, (int)user);
+        }
+    }
+}
+
+/* Append all rows of src to dst */
+static int columns_append(InputColumns *dst, const InputColumns *src) {
+    while (dst->cap < dst->n + src->n)
+        if (columns_grow(dst) != 0) return -1;
+    size_t n = src->n, at = dst->n;
+    memcpy(dst->player_name + at, src->player_name, n * sizeof(*src->player_name));
+    memcpy(dst->team + at, src->team, n * sizeof(*src->team));
+    memcpy(dst->game + at, src->game, n * sizeof(*src->game));
+    memcpy(dst->archetype + at, src->archetype, n * sizeof(*src->archetype));
+    for (size_t k = 0; k < N_INPUT_FIELDS; ++k)
+        memcpy(column_ptr(dst, &INPUT_FIELDS[k]) + at, column_ptr((InputColumns *)src, &INPUT_FIELDS[k]),
+               n * sizeof(double));
+    dst->n += n;
+    return 0;
+}
+
+static int cmd_ingest(int argc, char **argv) {
+    int n_threads = 2, use_uring = 1;
+    while (argc >= 1 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--no-uring") == 0) { use_uring = 0; --argc; ++argv; }
+        else if (strcmp(argv[0], "--threads") == 0 && argc >= 2) { n_threads = atoi(argv[1]); argc -= 2; argv += 2; }
+        else break;
+    }
+    if (argc < 2 || n_threads < 1) {
+        fprintf(stderr, "usage: points_model ingest [--threads N] [--no-uring] <out.snap> <file.csv>...\n");
+        return 2;
+    }
+
+    Ingest g;
+    memset(&g, 0, sizeof(g));
+    g.paths = argv + 1;
+    g.n_files = argc - 1;
+    g.files = calloc((size_t)g.n_files, sizeof(*g.files));
+    g.file_ok = calloc((size_t)g.n_files, sizeof(*g.file_ok));
+    char *pool = aligned_alloc(4096, INGEST_SLOTS * (size_t)(INGEST_BUF_SIZE + 4096));
+    pthread_t *tid = calloc((size_t)n_threads, sizeof(*tid));
+    if (!g.files || !g.file_ok || !pool || !tid) {
+        free(g.files); free(g.file_ok); free(pool); free(tid);
+        return 1;
+    }
+    slot_queue_init(&g.free_q);
+    slot_queue_init(&g.ready_q);
+    struct iovec iov[INGEST_SLOTS];
+    for (int k = 0; k < INGEST_SLOTS; ++k) {
+        g.slots[k].buf = pool + (size_t)k * (INGEST_BUF_SIZE + 4096);
+        iov[k].iov_base = g.slots[k].buf;
+        iov[k].iov_len = INGEST_BUF_SIZE;
+        slot_queue_push(&g.free_q, k);
+    }
+
+    Uring ring;
+    int have_ring = use_uring && uring_init(&ring, 2 * INGEST_SLOTS) == 0;
+    int fixed = have_ring &&
+                syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iov, INGEST_SLOTS) == 0;
+    const char *mode = !have_ring ? "blocking reads" : fixed ? "io_uring, registered buffers" : "io_uring";
+
+    double t0 = now_seconds();
+    int started = 0;
+    for (; started < n_threads; ++started)
+        if (pthread_create(&tid[started], NULL, ingest_parser, &g) != 0) break;
+    if (started > 0) ingest_read(&g, have_ring ? &ring : NULL, fixed);
+    slot_queue_close(&g.ready_q);
+    for (int k = 0; k < started; ++k) pthread_join(tid[k], NULL);
+    double t1 = now_seconds();
+
+    int rc = 0, failed = 0;
+    InputColumns all;
+    if (columns_alloc(&all, 256) != 0) rc = -1;
+    for (int f = 0; f < g.n_files; ++f) {
+        if (!g.file_ok[f]) { ++failed; continue; }
+        if (rc == 0 && columns_append(&all, &g.files[f]) != 0) rc = -1;
+    }
+    if (failed) fprintf(stderr, "%d of %d files failed; store not written\n", failed, g.n_files);
+    size_t *perm = rc == 0 && !failed ? date_order(&all) : NULL;
+    if (perm && snapshot_write(argv[0], &all, perm, NULL, 0, NULL) == 0)
+        fprintf(stderr, "ingested %d files (%.1f MB, %zu rows) with %s in %.3f ms; wrote %s\n",
+                g.n_files, g.bytes / 1e6, all.n, mode, (t1 - t0) * 1e3, argv[0]);
+    else
+        rc = -1;
+
+    free(perm);
+    columns_free(&all);
+    for (int f = 0; f < g.n_files; ++f) columns_free(&g.files[f]);
+    if (have_ring) uring_free(&ring);
+    slot_queue_free(&g.free_q);
+    slot_queue_free(&g.ready_q);
+    free(g.files);
+    free(g.file_ok);
+    free(pool);
+    free(tid);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== BACKTEST ========================*/
+
+/* Season-scale backtests sharded across worker processes. The coordinator
+ * splits a date-sorted history store into (season, date range, weight
+ * profile) work units and hands them to forked workers over AF_UNIX
+ * SOCK_SEQPACKET socketpairs, one unit in flight per worker. Each worker
+ * mmaps the store itself and runs project_batch() over the unit's row
+ * range, returning error and line-side hit sums. Results are merged in
+ * unit order, so totals are identical for any worker count or schedule.
+ * A worker that dies (EOF / hangup on its socket) is reaped and replaced,
+ * and its unit goes back in the queue; a unit that kills
+ * BACKTEST_MAX_ATTEMPTS workers is reported as failed. */
+#define BACKTEST_MAX_PROFILES 8
+#define BACKTEST_MAX_ATTEMPTS 3
+#define BACKTEST_CHUNK        1024
+
+typedef struct {
+    int32_t id;
+    int32_t profile;
+    int32_t date_lo, date_hi;      /* yyyymmdd, inclusive */
+} BacktestUnit;
+
+typedef struct {
+    int32_t id;
+    int32_t ok;
+    double n, sum_err, sum_abs, sum_sq;
+    double sides, hits;            /* rows with actual != line, and correct over/under calls */
+} BacktestResult;
+
+/* Days since 1970-01-01 for a yyyymmdd date (proleptic Gregorian) */
+static long days_from_yyyymmdd(long d) {
+    long y = d / 10000, m = d / 100 % 100, dd = d % 100;
+    y -= m <= 2;
+    long era = (y >= 0 ? y : y - 399) / 400;
+    long yoe = y - era * 400;
+    long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + dd - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/* NBA seasons are labeled by the year they end in (Oct 2024 -> 2025) */
+static int season_of(long date) {
+    long y = date / 10000, m = date / 100 % 100;
+    return (int)(m >= 8 ? y + 1 : y);
+}
+
+/* First row with date >= d in a date-sorted store */
+static size_t date_lower_bound(const InputColumns *c, double d) {
+    size_t lo = 0, hi = c->n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (c->game_date[mid] < d) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static void backtest_run_unit(const InputColumns *c, const BacktestUnit *u, BacktestResult *r) {
+    double base[BACKTEST_CHUNK], mult[BACKTEST_CHUNK], proj[BACKTEST_CHUNK];
+    OutputColumns o = { base, mult, proj };
+    memset(r, 0, sizeof(*r));
+    r->id = u->id;
+    r->ok = 1;
+
+    size_t lo = date_lower_bound(c, u->date_lo), hi = date_lower_bound(c, u->date_hi + 1.0);
+    for (size_t b = lo; b < hi; b += BACKTEST_CHUNK) {
+        size_t e = hi - b < BACKTEST_CHUNK ? hi : b + BACKTEST_CHUNK;
+        project_batch(c, b, e, u->profile, &o);
+        for (size_t i = b; i < e; ++i) {
+            double actual = c->actual_pts[i], line = c->player_line_pts[i];
+            if (isnan(actual) || c->is_out[i] != 0.0) continue;
+            double err = proj[i - b] - actual;
+            r->n += 1.0;
+            r->sum_err += err;
+            r->sum_abs += fabs(err);
+            r->sum_sq  += err * err;
+            if (actual != line && proj[i - b] != line) {
+                r->sides += 1.0;
+                r->hits  += (proj[i - b] > line) == (actual > line);
+            }
+        }
+    }
+}
+
+static void backtest_worker(int fd, const char *store) {
+    Snapshot s;
+    InputColumns c;
+    if (snapshot_open(store, &s) != 0) _exit(1);
+    if (snapshot_columns(&s, &c) != 0) _exit(1);
+
+    BacktestUnit u;
+    BacktestResult r;
+    while (read(fd, &u, sizeof(u)) == (ssize_t)sizeof(u)) {
+        backtest_run_unit(&c, &u, &r);
+        if (write(fd, &r, sizeof(r)) != (ssize_t)sizeof(r)) break;
+    }
+    _exit(0);
+}
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    int unit;                      /* in-flight unit, -1 idle */
+} BacktestWorker;
+
+/* Start worker k. The child drops its copies of the other workers' sockets
+ * so a dead worker's peer sees EOF and closing a socket ends its worker. */
+static int backtest_spawn(BacktestWorker *w, int n_workers, int k, const char *store) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) != 0) { perror("socketpair"); return -1; }
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork"); close(sv[0]); close(sv[1]); return -1; }
+    if (pid == 0) {
+        close(sv[0]);
+        for (int j = 0; j < n_workers; ++j)
+            if (j != k && w[j].fd >= 0) close(w[j].fd);
+        backtest_worker(sv[1], store);
+    }
+    close(sv[1]);
+    w[k].pid = pid;
+    w[k].fd = sv[0];
+    w[k].unit = -1;
+    return 0;
+}
+
+static void backtest_reap(BacktestWorker *w) {
+    close(w->fd);
+    waitpid(w->pid, NULL, 0);
+    w->fd = -1;
+    w->pid = -1;
+}
+
+/* Unit u was lost with its worker: queue it again, or give up on it after
+ * BACKTEST_MAX_ATTEMPTS */
+static void backtest_requeue(int u, const int *attempts, BacktestResult *results, unsigned char *state,
+                             int *done, int *next) {
+    if (attempts[u] >= BACKTEST_MAX_ATTEMPTS) {
+        results[u].id = u;
+        results[u].ok = 0;
+        state[u] = 2;
+        ++*done;
+    } else {
+        state[u] = 0;
+        if (u < *next) *next = u;
+    }
+}
+
+static int cmd_backtest(int argc, char **argv) {
+    int n_workers = 4, chunk_days = 14, n_profiles = 0;
+    int profiles[BACKTEST_MAX_PROFILES];
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--workers") == 0) {
+            n_workers = atoi(argv[1]);
+        } else if (strcmp(argv[0], "--days") == 0) {
+            chunk_days = atoi(argv[1]);
+        } else if (strcmp(argv[0], "--profiles") == 0) {
+            char buf[256];
+            snprintf(buf, sizeof(buf), "%s", argv[1]);
+            for (char *p = strtok(buf, ","); p && n_profiles < BACKTEST_MAX_PROFILES; p = strtok(NULL, ","))
+                profiles[n_profiles++] = strcmp(p, "mult") == 0 ? PROFILE_PER_ROW : (int)archetype_from_name(p);
+        } else {
+            break;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1 || n_workers < 1 || chunk_days < 1) {
+        fprintf(stderr, "usage: points_model backtest [--workers N] [--days D] [--profiles mult,guard,...] <store.snap>\n");
+        return 2;
+    }
+    if (n_profiles == 0) profiles[n_profiles++] = PROFILE_PER_ROW;
+    const char *store = argv[0];
+
+    /* Build units from the store's date span */
+    Snapshot s;
+    InputColumns c;
+    if (snapshot_open(store, &s) != 0) return 1;
+    if (snapshot_columns(&s, &c) != 0 || c.n == 0) {
+        fprintf(stderr, "%s: empty store\n", store);
+        columns_free(&c);
+        snapshot_close(&s);
+        return 1;
+    }
+    for (size_t i = 1; i < c.n; ++i)
+        if (c.game_date[i] < c.game_date[i - 1]) {
+            fprintf(stderr, "%s: store is not sorted by date (write it with 'snapshot')\n", store);
+            columns_free(&c);
+            snapshot_close(&s);
+            return 1;
+        }
+
+    BacktestUnit *units = NULL;
+    int n_units = 0, cap_units = 0;
+    for (size_t i = 0; i < c.n;) {
+        long first = (long)c.game_date[i];
+        int season = season_of(first);
+        long day0 = days_from_yyyymmdd(first);
+        long last = first;
+        size_t j = i;
+        while (j < c.n && season_of((long)c.game_date[j]) == season &&
+               days_from_yyyymmdd((long)c.game_date[j]) < day0 + chunk_days)
+            last = (long)c.game_date[j++];
+        for (int p = 0; p < n_profiles; ++p) {
+            if (n_units == cap_units) {
+                cap_units = cap_units ? 2 * cap_units : 64;
+                BacktestUnit *nu = realloc(units, (size_t)cap_units * sizeof(*nu));
+                if (!nu) { free(units); columns_free(&c); snapshot_close(&s); return 1; }
+                units = nu;
+            }
+            units[n_units] = (BacktestUnit){ n_units, profiles[p], (int32_t)first, (int32_t)last };
+            ++n_units;
+        }
+        i = j;
+    }
+    columns_free(&c);
+    snapshot_close(&s);
+
+    BacktestResult *results = calloc((size_t)n_units, sizeof(*results));
+    int *attempts = calloc((size_t)n_units, sizeof(int));
+    unsigned char *state = calloc((size_t)n_units, 1);       /* 0 queued, 1 running, 2 done */
+    BacktestWorker *w = calloc((size_t)n_workers, sizeof(*w));
+    struct pollfd *pfd = calloc((size_t)n_workers, sizeof(*pfd));
+    if (!results || !attempts || !state || !w || !pfd) {
+        free(results); free(attempts); free(state); free(w); free(pfd); free(units);
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    double t0 = now_seconds();
+    int alive = 0;
+    for (int k = 0; k < n_workers; ++k) w[k].fd = -1;
+    for (int k = 0; k < n_workers; ++k)
+        if (backtest_spawn(w, n_workers, k, store) == 0) ++alive;
+
+    int done = 0, next = 0;
+    while (done < n_units && alive > 0) {
+        /* Hand queued units to idle workers */
+        for (int k = 0; k < n_workers; ++k) {
+            if (w[k].fd < 0 || w[k].unit >= 0) continue;
+            while (next < n_units && state[next] != 0) ++next;
+            int u = next;
+            if (u >= n_units) {
+                for (u = 0; u < n_units && state[u] != 0; ++u) {}
+                if (u >= n_units) break;
+            }
+            state[u] = 1;
+            attempts[u]++;
+            if (write(w[k].fd, &units[u], sizeof(units[u])) != (ssize_t)sizeof(units[u])) {
+                /* Worker already gone (EPIPE): replace it like a death mid-unit */
+                fprintf(stderr, "backtest: worker %d exited before unit %d\n", (int)w[k].pid, u);
+                backtest_reap(&w[k]);
+                --alive;
+                backtest_requeue(u, attempts, results, state, &done, &next);
+                if (done < n_units && backtest_spawn(w, n_workers, k, store) == 0) ++alive;
+                continue;
+            }
+            w[k].unit = u;
+        }
+
+        int busy = 0;
+        for (int k = 0; k < n_workers; ++k) busy |= w[k].fd >= 0 && w[k].unit >= 0;
+        if (!busy) continue;           /* every hand-off failed: retry with the replacements */
+        for (int k = 0; k < n_workers; ++k) {
+            pfd[k].fd = w[k].unit >= 0 ? w[k].fd : -1;
+            pfd[k].events = POLLIN;
+            pfd[k].revents = 0;
+        }
+        if (poll(pfd, (nfds_t)n_workers, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        for (int k = 0; k < n_workers; ++k) {
+            if (!pfd[k].revents) continue;
+            BacktestResult r;
+            ssize_t got = (pfd[k].revents & POLLIN) ? read(w[k].fd, &r, sizeof(r)) : 0;
+            int u = w[k].unit;
+            if (got == (ssize_t)sizeof(r) && r.id == u) {
+                results[u] = r;
+                state[u] = 2;
+                ++done;
+                w[k].unit = -1;
+                continue;
+            }
+
+            /* Worker died mid-unit: requeue (or give up on) the unit and replace it */
+            fprintf(stderr, "backtest: worker %d died on unit %d\n", (int)w[k].pid, u);
+            backtest_reap(&w[k]);
+            --alive;
+            backtest_requeue(u, attempts, results, state, &done, &next);
+            if (done < n_units && backtest_spawn(w, n_workers, k, store) == 0) ++alive;
+        }
+    }
+    for (int k = 0; k < n_workers; ++k)
+        if (w[k].fd >= 0) backtest_reap(&w[k]);
+    double t1 = now_seconds();
+
+    /* Deterministic merge: walk units in id order into (season, profile) rows */
+    printf("%-8s %-12s %9s %8s %8s %8s %8s\n", "season", "profile", "rows", "mae", "rmse", "bias", "hit%");
+    int failed = 0;
+    for (int p = 0; p < n_profiles; ++p) {
+        const char *pname = profiles[p] == PROFILE_PER_ROW ? "mult" : ARCHETYPE_SCALES[profiles[p]].name;
+        BacktestResult tot;
+        memset(&tot, 0, sizeof(tot));
+        int season = 0;
+        for (int u = 0; u < n_units; ++u) {
+            if (units[u].profile != profiles[p]) continue;
+            const BacktestResult *r = &results[u];
+            if (!r->ok) { ++failed; continue; }
+            season = season_of(units[u].date_lo);
+            tot.n += r->n; tot.sum_err += r->sum_err; tot.sum_abs += r->sum_abs;
+            tot.sum_sq += r->sum_sq; tot.sides += r->sides; tot.hits += r->hits;
+
+            int last = 1;
+            for (int v = u + 1; v < n_units; ++v)
+                if (units[v].profile == profiles[p]) { last = season_of(units[v].date_lo) != season; break; }
+            if (!last || tot.n == 0) continue;
+            printf("%-8d %-12s %9.0f %8.3f %8.3f %+8.3f %8.2f\n", season, pname,
+                   tot.n, tot.sum_abs / tot.n, sqrt(tot.sum_sq / tot.n), tot.sum_err / tot.n,
+                   tot.sides > 0 ? 100.0 * tot.hits / tot.sides : 0.0);
+            memset(&tot, 0, sizeof(tot));
+        }
+    }
+    fprintf(stderr, "%d units (%d failed) on %d workers in %.3f ms\n", n_units, failed, n_workers, (t1 - t0) * 1e3);
+
+    free(results); free(attempts); free(state); free(w); free(pfd); free(units);
+    return done == n_units && failed == 0 ? 0 : 1;
+}
+
+/*======================== LINE HISTORY ========================*/
+
+/* Append-only tick store for line movement (line, game_total, team_total,
+ * or any other slate field). Ticks arrive as "ts,key,field,value" lines,
+ * the feature log's layout, with ts = yyyymmdd[HHMM[SS]] and key = player
+ * or game, unprefixed. A series is one (key, field); its ticks are cut
+ * into blocks of up to TS_BLOCK_TICKS, each bit-packed Gorilla style:
+ *
+ *   time   first tick raw in the block header, then delta-of-delta in
+ *          0 / 10+7 / 110+9 / 1110+12 / 1111+64 bits (most ticks: 1 bit
+ *          when the feed is regular, 9 bits otherwise)
+ *   value  fixed-point hundredths, delta-coded with the same buckets, when
+ *          every value in the block is exact at that scale (half-point
+ *          lines: a 0.5 move is 9 bits, no move is 1 bit); otherwise XOR
+ *          against the previous double with a leading / trailing-zero window
+ *
+ * File: TsRecord (series definition + key) or TsRecord (block header +
+ * payload), appended in any interleaving. Opening walks only the record
+ * headers and builds the per-series block index (time range per block),
+ * so a range scan binary-searches to the first block and decodes only
+ * blocks overlapping [from, to]. Appends add new blocks; ticks older than
+ * a series' last tick are rejected. An append run ends by flushing every
+ * series' partial block, and the next run reopens those trailing partial
+ * blocks (they are the file's tail) and rewrites them with its new ticks,
+ * so a feed appended a few ticks at a time still fills whole blocks.
+ *
+ * Committed blocks are never cut before their replacement is durable: a
+ * run that reopens the tail writes its output to <store>.journal, stamps
+ * the journal's header (store offset, length, checksum) and fsyncs it as
+ * the commit point, and only then cuts the store at that offset and copies
+ * the journal in. Opening a store first finishes a committed journal left
+ * by a crash and discards an uncommitted one, so the store holds either
+ * the previous run's blocks or the new run's, never neither. */
+#define TS_MAGIC       "NBATSS1"
+#define TS_JOURNAL_MAGIC "NBATSJ1"
+#define TS_BLOCK_TICKS 1024
+#define TS_FIXED_SCALE 100.0
+
+enum { TS_REC_SERIES = 1, TS_REC_BLOCK = 2 };
+enum { TS_ENC_FIXED = 1, TS_ENC_XOR = 2 };
+
+typedef struct {
+    uint32_t kind;
+    uint32_t series;
+    uint32_t count;                /* ticks in a block; field for a series */
+    uint32_t bytes;                /* payload bytes that follow */
+    int64_t t_first, t_last;       /* epoch seconds */
+    double v_first;
+    uint32_t enc;
+    uint32_t pad;
+} TsRecord;
+
+typedef struct {
+    char magic[8];
+    uint64_t offset;               /* store offset the records replace from */
+    uint64_t bytes;                /* record bytes that follow */
+    uint32_t check;                /* FNV-1a of those bytes; 0 bytes = uncommitted */
+    uint32_t pad;
+} TsJournalHeader;
+
+typedef struct {
+    int64_t t_first, t_last;
+    size_t offset;                 /* of the payload */
+    uint32_t count, bytes, enc;
+    double v_first;
+} TsBlockRef;
+
+typedef struct {
+    char key[NAME_LEN];
+    int field;
+    int next;                      /* next series with the same key, -1 = none */
+    TsBlockRef *blocks;
+    size_t n_blocks, cap_blocks;
+    int64_t *open_t;               /* ticks not yet in a block (appends) */
+    double *open_v;
+    size_t n_open;
+    int64_t last_t;
+    uint64_t ticks;
+} TsSeries;
+
+typedef struct {
+    void *base;
+    size_t len;
+    TsSeries *series;
+    size_t n_series, cap_series;
+    NameIndex keys;                /* key -> first series */
+    FILE *out;                     /* appends */
+    uint64_t bytes_payload;
+} TsStore;
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap, bits;
+} BitWriter;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len, pos;               /* pos in bits */
+} BitReader;
+
+static int bits_put(BitWriter *w, uint64_t v, int n) {
+    if ((w->bits + (size_t)n + 7) / 8 > w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 4096;
+        uint8_t *buf = realloc(w->buf, cap);
+        if (!buf) return -1;
+        memset(buf + w->cap, 0, cap - w->cap);
+        w->buf = buf;
+        w->cap = cap;
+    }
+    for (int k = n - 1; k >= 0; --k, ++w->bits)
+        if ((v >> k) & 1) w->buf[w->bits >> 3] |= (uint8_t)(0x80u >> (w->bits & 7));
+    return 0;
+}
+
+/* Next n <= 56 bits, MSB first */
+static uint64_t bits_get(BitReader *r, int n) {
+    if (n == 0) return 0;
+    size_t byte = r->pos >> 3;
+    uint64_t word = 0;
+    if (byte + 8 <= r->len) {
+        memcpy(&word, r->buf + byte, sizeof(word));
+        word = __builtin_bswap64(word);
+    } else {
+        for (int k = 0; k < 8; ++k) word = word << 8 | (byte + (size_t)k < r->len ? r->buf[byte + (size_t)k] : 0);
+    }
+    uint64_t v = (word << (r->pos & 7)) >> (64 - n);
+    r->pos += (size_t)n;
+    return v;
+}
+
+static uint64_t bits_get64(BitReader *r) {
+    uint64_t hi = bits_get(r, 32);
+    return hi << 32 | bits_get(r, 32);
+}
+
+static int ts_put_signed(BitWriter *w, int64_t v) {
+    if (v == 0) return bits_put(w, 0, 1);
+    if (v >= -63 && v <= 64) return bits_put(w, 2, 2) | bits_put(w, (uint64_t)(v + 63), 7);
+    if (v >= -255 && v <= 256) return bits_put(w, 6, 3) | bits_put(w, (uint64_t)(v + 255), 9);
+    if (v >= -2047 && v <= 2048) return bits_put(w, 14, 4) | bits_put(w, (uint64_t)(v + 2047), 12);
+    return bits_put(w, 15, 4) | bits_put(w, (uint64_t)v >> 32, 32) | bits_put(w, (uint32_t)v, 32);
+}
+
+static int64_t ts_get_signed(BitReader *r) {
+    if (!bits_get(r, 1)) return 0;
+    if (!bits_get(r, 1)) return (int64_t)bits_get(r, 7) - 63;
+    if (!bits_get(r, 1)) return (int64_t)bits_get(r, 9) - 255;
+    if (!bits_get(r, 1)) return (int64_t)bits_get(r, 12) - 2047;
+    return (int64_t)bits_get64(r);
+}
+
+static uint64_t ts_double_bits(double v) {
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+static double ts_bits_double(uint64_t u) {
+    double v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+static int ts_fixed_ok(const double *v, size_t n) {
+    for (size_t k = 0; k < n; ++k)
+        if (!(fabs(v[k]) < 1e12) || (double)llround(v[k] * TS_FIXED_SCALE) / TS_FIXED_SCALE != v[k]) return 0;
+    return 1;
+}
+
+/* Encode ticks [1, n) after the first (kept in the header) */
+static int ts_encode(const int64_t *t, const double *v, size_t n, uint32_t enc, BitWriter *w) {
+    int rc = 0, lead = -1, trail = 0;
+    int64_t prev_delta = 0;
+    for (size_t k = 1; k < n && rc == 0; ++k) {
+        int64_t delta = t[k] - t[k - 1];
+        rc |= ts_put_signed(w, delta - prev_delta);
+        prev_delta = delta;
+        if (enc == TS_ENC_FIXED) {
+            rc |= ts_put_signed(w, llround(v[k] * TS_FIXED_SCALE) - llround(v[k - 1] * TS_FIXED_SCALE));
+            continue;
+        }
+        uint64_t x = ts_double_bits(v[k]) ^ ts_double_bits(v[k - 1]);
+        if (x == 0) { rc |= bits_put(w, 0, 1); continue; }
+        int l = __builtin_clzll(x), tr = __builtin_ctzll(x);
+        if (l > 31) l = 31;
+        if (lead >= 0 && l >= lead && tr >= trail) {
+            rc |= bits_put(w, 2, 2) | bits_put(w, x >> trail, 64 - lead - trail);
+        } else {
+            lead = l;
+            trail = tr;
+            int len = 64 - lead - trail;
+            rc |= bits_put(w, 3, 2) | bits_put(w, (uint64_t)lead, 5) | bits_put(w, (uint64_t)(len - 1), 6) |
+                  bits_put(w, (x >> trail) >> 32, len > 32 ? len - 32 : 0) | bits_put(w, (uint32_t)(x >> trail), len > 32 ? 32 : len);
+        }
+    }
+    return rc;
+}
+
+static void ts_decode(const TsBlockRef *b, const uint8_t *payload, int64_t *t, double *v) {
+    BitReader r = { payload, b->bytes, 0 };
+    int lead = 0, trail = 0;
+    int64_t delta = 0, q = llround(b->v_first * TS_FIXED_SCALE);
+    t[0] = b->t_first;
+    v[0] = b->v_first;
+    for (uint32_t k = 1; k < b->count; ++k) {
+        delta += ts_get_signed(&r);
+        t[k] = t[k - 1] + delta;
+        if (b->enc == TS_ENC_FIXED) {
+            q += ts_get_signed(&r);
+            v[k] = (double)q / TS_FIXED_SCALE;
+            continue;
+        }
+        if (!bits_get(&r, 1)) { v[k] = v[k - 1]; continue; }
+        if (bits_get(&r, 1)) {
+            lead = (int)bits_get(&r, 5);
+            trail = 64 - lead - ((int)bits_get(&r, 6) + 1);
+        }
+        int len = 64 - lead - trail;
+        uint64_t x = len > 32 ? bits_get(&r, len - 32) << 32 : 0;
+        x |= bits_get(&r, len > 32 ? 32 : len);
+        v[k] = ts_bits_double(ts_double_bits(v[k - 1]) ^ (x << trail));
+    }
+}
+
+/* yyyymmdd[HHMM[SS]] -> epoch seconds; INT64_MIN if malformed or out of range */
+static int64_t ts_seconds(const char *s) {
+    char *end;
+    long long d = strtoll(s, &end, 10);
+    size_t digits = (size_t)(end - s);
+    long long hms = 0;
+    if (digits == 14)      { hms = d % 1000000; d /= 1000000; }
+    else if (digits == 12) { hms = d % 10000 * 100; d /= 10000; }
+    else if (digits != 8)  return INT64_MIN;
+    if (*end || d / 100 % 100 < 1 || d / 100 % 100 > 12 || d % 100 < 1 || d % 100 > 31 ||
+        hms / 10000 > 23 || hms / 100 % 100 > 59 || hms % 100 > 59) return INT64_MIN;
+    return (int64_t)days_from_yyyymmdd((long)d) * 86400 + hms / 10000 * 3600 + hms / 100 % 100 * 60 + hms % 100;
+}
+
+/* epoch seconds -> "yyyymmddHHMMSS" */
+static void ts_format(int64_t sec, char *buf, size_t size) {
+    int64_t days = sec >= 0 ? sec / 86400 : -((-sec + 86399) / 86400), rem = sec - days * 86400;
+    int64_t z = days + 719468, era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097, yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100), mp = (5 * doy + 2) / 153;
+    int64_t dd = doy - (153 * mp + 2) / 5 + 1, mm = mp < 10 ? mp + 3 : mp - 9, yy = yoe + era * 400 + (mm <= 2);
+    snprintf(buf, size, "%04lld%02lld%02lld%02lld%02lld%02lld", (long long)yy, (long long)mm, (long long)dd,
+             (long long)(rem / 3600), (long long)(rem / 60 % 60), (long long)(rem % 60));
+}
+
+static int ts_series_find(const TsStore *st, const char *key, int field) {
+    int s = name_index_find(&st->keys, key);
+    while (s >= 0 && st->series[s].field != field) s = st->series[s].next;
+    return s;
+}
+
+static int ts_series_add(TsStore *st, const char *key, int field) {
+    if (st->n_series == st->cap_series) {
+        size_t cap = st->cap_series ? st->cap_series * 2 : 256;
+        TsSeries *v = realloc(st->series, cap * sizeof(*v));
+        if (!v) return -1;
+        st->series = v;
+        st->cap_series = cap;
+    }
+    int s = (int)st->n_series++;
+    TsSeries *ts = &st->series[s];
+    memset(ts, 0, sizeof(*ts));
+    snprintf(ts->key, NAME_LEN, "%s", key);
+    ts->field = field;
+    ts->last_t = INT64_MIN;
+    ts->next = name_index_find(&st->keys, key);
+    return name_index_put(&st->keys, key, s) == 0 ? s : -1;
+}
+
+static int ts_block_add(TsSeries *ts, const TsBlockRef *b) {
+    if (ts->n_blocks == ts->cap_blocks) {
+        size_t cap = ts->cap_blocks ? ts->cap_blocks * 2 : 8;
+        TsBlockRef *v = realloc(ts->blocks, cap * sizeof(*v));
+        if (!v) return -1;
+        ts->blocks = v;
+        ts->cap_blocks = cap;
+    }
+    ts->blocks[ts->n_blocks++] = *b;
+    ts->last_t = b->t_last;
+    ts->ticks += b->count;
+    return 0;
+}
+
+static void ts_close(TsStore *st) {
+    if (st->out) fclose(st->out);
+    for (size_t s = 0; s < st->n_series; ++s) {
+        free(st->series[s].blocks);
+        free(st->series[s].open_t);
+        free(st->series[s].open_v);
+    }
+    free(st->series);
+    name_index_free(&st->keys);
+    if (st->base) munmap(st->base, st->len);
+    memset(st, 0, sizeof(*st));
+}
+
+static uint32_t ts_fnv(uint32_t h, const unsigned char *p, size_t n) {
+    for (size_t k = 0; k < n; ++k) h = (h ^ p[k]) * 16777619u;
+    return h;
+}
+
+/* Finish a committed journal (cut the store at its offset and copy its
+ * records in) or drop an uncommitted one */
+static int ts_journal_recover(const char *path) {
+    char jpath[4096];
+    snprintf(jpath, sizeof(jpath), "%s.journal", path);
+    FILE *jf = fopen(jpath, "rb");
+    if (!jf) {
+        if (errno == ENOENT) return 0;
+        perror(jpath);
+        return -1;
+    }
+
+    TsJournalHeader h;
+    unsigned char buf[65536];
+    uint32_t check = 2166136261u;
+    uint64_t seen = 0;
+    size_t got;
+    int committed = fread(&h, sizeof(h), 1, jf) == 1 && memcmp(h.magic, TS_JOURNAL_MAGIC, sizeof(TS_JOURNAL_MAGIC)) == 0 &&
+                    h.bytes > 0;
+    while (committed && (got = fread(buf, 1, sizeof(buf), jf)) > 0) {
+        check = ts_fnv(check, buf, got);
+        seen += got;
+    }
+    committed = committed && seen == h.bytes && check == h.check;
+
+    int rc = 0;
+    if (committed) {
+        int fd = open(path, O_WRONLY);
+        rc = fd >= 0 && ftruncate(fd, (off_t)h.offset) == 0 && lseek(fd, (off_t)h.offset, SEEK_SET) >= 0 &&
+             fseek(jf, (long)sizeof(h), SEEK_SET) == 0 ? 0 : -1;
+        while (rc == 0 && (got = fread(buf, 1, sizeof(buf), jf)) > 0)
+            if (write(fd, buf, got) != (ssize_t)got) rc = -1;
+        if (rc == 0 && fsync(fd) != 0) rc = -1;
+        if (fd >= 0) close(fd);
+        if (rc != 0) perror(path);
+    }
+    fclose(jf);
+    if (rc == 0 && unlink(jpath) != 0) { perror(jpath); rc = -1; }
+    return rc;
+}
+
+/* Stamp the journal's header once its records are written; fsync = commit */
+static int ts_journal_commit(FILE *jf, uint64_t offset) {
+    TsJournalHeader h;
+    unsigned char buf[65536];
+    size_t got;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TS_JOURNAL_MAGIC, sizeof(TS_JOURNAL_MAGIC));
+    h.offset = offset;
+    h.check = 2166136261u;
+    if (fflush(jf) != 0 || fseek(jf, (long)sizeof(h), SEEK_SET) != 0) return -1;
+    while ((got = fread(buf, 1, sizeof(buf), jf)) > 0) {
+        h.check = ts_fnv(h.check, buf, got);
+        h.bytes += got;
+    }
+    if (ferror(jf) || fseek(jf, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, jf) != 1) return -1;
+    return fflush(jf) == 0 && fsync(fileno(jf)) == 0 ? 0 : -1;
+}
+
+/* Map a store and index its blocks; a missing file is an empty store */
+static int ts_open(const char *path, TsStore *st) {
+    memset(st, 0, sizeof(*st));
+    if (ts_journal_recover(path) != 0) return -1;
+    if (name_index_init(&st->keys, 1024) != 0) return -1;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) return 0;
+        perror(path);
+        return -1;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) { perror(path); close(fd); return -1; }
+    st->len = (size_t)sb.st_size;
+    if (st->len > 0 && (st->base = mmap(NULL, st->len, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        st->base = NULL;
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    if (st->len == 0) return 0;
+    if (st->len < 8 || memcmp(st->base, TS_MAGIC, sizeof(TS_MAGIC)) != 0) {
+        fprintf(stderr, "%s: not a line history store\n", path);
+        return -1;
+    }
+
+    size_t off = 8;
+    while (off + sizeof(TsRecord) <= st->len) {
+        TsRecord rec;                     /* payloads are unpadded: headers may be unaligned */
+        memcpy(&rec, (const char *)st->base + off, sizeof(rec));
+        const TsRecord *r = &rec;
+        size_t payload = off + sizeof(*r);
+        if (payload + r->bytes > st->len) break;              /* torn tail; so is a malformed record */
+        if (r->kind == TS_REC_SERIES) {
+            char key[NAME_LEN];
+            snprintf(key, sizeof(key), "%.*s", (int)(r->bytes < NAME_LEN ? r->bytes : NAME_LEN - 1),
+                     (const char *)st->base + payload);
+            if (r->series != st->n_series || ts_series_add(st, key, (int)r->count) < 0) break;
+        } else if (r->kind == TS_REC_BLOCK && r->series < st->n_series && r->count >= 1 &&
+                   r->count <= TS_BLOCK_TICKS && (r->enc == TS_ENC_FIXED || r->enc == TS_ENC_XOR) &&
+                   r->t_first <= r->t_last && r->t_first >= st->series[r->series].last_t) {
+            TsBlockRef b = { r->t_first, r->t_last, payload, r->count, r->bytes, r->enc, r->v_first };
+            if (ts_block_add(&st->series[r->series], &b) != 0) return -1;
+            st->bytes_payload += sizeof(*r) + r->bytes;
+        } else {
+            break;
+        }
+        off = payload + r->bytes;
+    }
+    if (off < st->len) fprintf(stderr, "%s: ignoring %zu bytes at the tail\n", path, st->len - off);
+    st->len = off;
+    return 0;
+}
+
+static int ts_flush_series(TsStore *st, int s) {
+    TsSeries *ts = &st->series[s];
+    if (ts->n_open == 0) return 0;
+    uint32_t enc = ts_fixed_ok(ts->open_v, ts->n_open) ? TS_ENC_FIXED : TS_ENC_XOR;
+    BitWriter w = { NULL, 0, 0 };
+    int rc = ts_encode(ts->open_t, ts->open_v, ts->n_open, enc, &w);
+    TsRecord r;
+    memset(&r, 0, sizeof(r));
+    r.kind = TS_REC_BLOCK;
+    r.series = (uint32_t)s;
+    r.count = (uint32_t)ts->n_open;
+    r.bytes = (uint32_t)((w.bits + 7) / 8);
+    r.t_first = ts->open_t[0];
+    r.t_last = ts->open_t[ts->n_open - 1];
+    r.v_first = ts->open_v[0];
+    r.enc = enc;
+    if (rc == 0 && (fwrite(&r, sizeof(r), 1, st->out) != 1 || (r.bytes && fwrite(w.buf, r.bytes, 1, st->out) != 1))) rc = -1;
+    free(w.buf);
+    st->bytes_payload += sizeof(r) + r.bytes;
+    ts->ticks += ts->n_open;
+    ts->n_open = 0;
+    return rc;
+}
+
+static int ts_append_tick(TsStore *st, const char *key, int field, int64_t t, double v) {
+    int s = ts_series_find(st, key, field);
+    if (s < 0) {
+        if ((s = ts_series_add(st, key, field)) < 0) return -1;
+        TsRecord r;
+        memset(&r, 0, sizeof(r));
+        r.kind = TS_REC_SERIES;
+        r.series = (uint32_t)s;
+        r.count = (uint32_t)field;
+        r.bytes = NAME_LEN;
+        if (fwrite(&r, sizeof(r), 1, st->out) != 1 || fwrite(st->series[s].key, NAME_LEN, 1, st->out) != 1) return -1;
+    }
+    TsSeries *ts = &st->series[s];
+    if (t < ts->last_t) return 1;
+    if (!ts->open_t) {
+        ts->open_t = malloc(TS_BLOCK_TICKS * sizeof(int64_t));
+        ts->open_v = malloc(TS_BLOCK_TICKS * sizeof(double));
+        if (!ts->open_t || !ts->open_v) return -1;
+    }
+    ts->open_t[ts->n_open] = t;
+    ts->open_v[ts->n_open++] = v;
+    ts->last_t = t;
+    return ts->n_open == TS_BLOCK_TICKS ? ts_flush_series(st, s) : 0;
+}
+
+typedef struct {
+    size_t offset;                 /* of the record */
+    int series;
+} TsTailBlock;
+
+static int ts_tail_block_cmp(const void *a, const void *b) {
+    const TsTailBlock *x = a, *y = b;
+    return x->offset < y->offset ? 1 : x->offset > y->offset ? -1 : 0;
+}
+
+/* Move the partial last blocks that form the file's tail back into their
+ * series' open ticks, to be rewritten by the next flush; st->len becomes
+ * the offset to append at. Returns the number of blocks reopened. */
+static long ts_reopen_tail(TsStore *st) {
+    TsTailBlock *tail = malloc((st->n_series ? st->n_series : 1) * sizeof(*tail));
+    size_t n = 0;
+    long reopened = 0;
+    if (!tail) return -1;
+    for (size_t s = 0; s < st->n_series; ++s) {
+        const TsSeries *ts = &st->series[s];
+        if (ts->n_blocks && ts->blocks[ts->n_blocks - 1].count < TS_BLOCK_TICKS)
+            tail[n++] = (TsTailBlock){ ts->blocks[ts->n_blocks - 1].offset - sizeof(TsRecord), (int)s };
+    }
+    qsort(tail, n, sizeof(*tail), ts_tail_block_cmp);
+    for (size_t k = 0; k < n; ++k) {
+        TsSeries *ts = &st->series[tail[k].series];
+        const TsBlockRef *b = &ts->blocks[ts->n_blocks - 1];
+        if (b->offset + b->bytes != st->len) break;
+        if (!ts->open_t) {
+            ts->open_t = malloc(TS_BLOCK_TICKS * sizeof(int64_t));
+            ts->open_v = malloc(TS_BLOCK_TICKS * sizeof(double));
+            if (!ts->open_t || !ts->open_v) { reopened = -1; break; }
+        }
+        ts_decode(b, (const uint8_t *)st->base + b->offset, ts->open_t, ts->open_v);
+        ts->n_open = b->count;
+        ts->ticks -= b->count;
+        st->bytes_payload -= sizeof(TsRecord) + b->bytes;
+        st->len = tail[k].offset;
+        --ts->n_blocks;
+        ++reopened;
+    }
+    free(tail);
+    return reopened;
+}
+
+/* Call fn for every tick of series s in [from, to]; returns ticks visited */
+typedef void (*TsTickFn)(int64_t t, double v, void *ctx);
+
+static size_t ts_scan(const TsStore *st, int s, int64_t from, int64_t to, TsTickFn fn, void *ctx) {
+    const TsSeries *ts = &st->series[s];
+    int64_t t[TS_BLOCK_TICKS];
+    double v[TS_BLOCK_TICKS];
+    size_t lo = 0, hi = ts->n_blocks, n = 0;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (ts->blocks[mid].t_last < from) lo = mid + 1; else hi = mid;
+    }
+    for (size_t k = lo; k < ts->n_blocks && ts->blocks[k].t_first <= to; ++k) {
+        const TsBlockRef *b = &ts->blocks[k];
+        ts_decode(b, (const uint8_t *)st->base + b->offset, t, v);
+        for (uint32_t j = 0; j < b->count; ++j)
+            if (t[j] >= from && t[j] <= to) { fn(t[j], v[j], ctx); ++n; }
+    }
+    return n;
+}
+
+static void ts_print_tick(int64_t t, double v, void *ctx) {
+    char buf[80];
+    (void)ctx;
+    ts_format(t, buf, sizeof(buf));
+    printf("%s %.17g\n", buf, v);
+}
+
+static int cmd_ticks(int argc, char **argv) {
+    const char *verb = argc >= 1 ? argv[0] : "";
+    int64_t from = INT64_MIN, to = INT64_MAX;
+    int bad_bound = 0;
+    --argc;
+    ++argv;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--from") == 0)    bad_bound |= (from = ts_seconds(argv[1])) == INT64_MIN;
+        else if (strcmp(argv[0], "--to") == 0) bad_bound |= (to = ts_seconds(argv[1])) == INT64_MIN;
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    int append = strcmp(verb, "append") == 0, scan = strcmp(verb, "scan") == 0, stats = strcmp(verb, "stats") == 0;
+    if (bad_bound || !((append && argc >= 1) || (scan && argc >= 3) || (stats && argc >= 1))) {
+        fprintf(stderr, "usage: points_model ticks append <store> [ticks.csv|-]\n"
+                        "       points_model ticks scan [--from ts] [--to ts] <store> <key> <field>\n"
+                        "       points_model ticks stats <store>\n");
+        return 2;
+    }
+
+    TsStore st;
+    if (ts_open(argv[0], &st) != 0) { ts_close(&st); return 1; }
+    int rc = 0;
+
+    if (append) {
+        FILE *in = argc >= 2 && strcmp(argv[1], "-") != 0 ? fopen(argv[1], "r") : stdin;
+        if (!in) { perror(argv[1]); ts_close(&st); return 1; }
+        /* Reopened partial blocks are rewritten through the journal; without
+         * any, cut off a torn tail and append in place */
+        char jpath[4096];
+        long reopened = ts_reopen_tail(&st);
+        snprintf(jpath, sizeof(jpath), "%s.journal", argv[0]);
+        if (reopened < 0) rc = -1;
+        if (rc == 0 && reopened > 0) {
+            TsJournalHeader h;
+            memset(&h, 0, sizeof(h));
+            if (!(st.out = fopen(jpath, "w+b")) || fwrite(&h, sizeof(h), 1, st.out) != 1) rc = -1;
+        } else if (rc == 0) {
+            if (truncate(argv[0], (off_t)st.len) != 0 && errno != ENOENT) rc = -1;
+            if (rc == 0 && !(st.out = fopen(argv[0], "ab"))) rc = -1;
+        }
+        if (rc == 0 && st.len == 0) {
+            char magic[8] = TS_MAGIC;
+            if (fwrite(magic, sizeof(magic), 1, st.out) != 1) rc = -1;
+        }
+        char line[512];
+        size_t added = 0, stale = 0, bad = 0;
+        double t0 = now_seconds();
+        while (rc == 0 && fgets(line, sizeof(line), in)) {
+            char *f[4];
+            if (line[0] == '#' || line[0] == '\n' || csv_split(line, f, 4) < 4) continue;
+            int64_t t = ts_seconds(f[0]);
+            int field = wal_field(f[2]);
+            char *end;
+            double v = strtod(f[3], &end);
+            if (t == INT64_MIN || field < 0 || end == f[3]) { ++bad; continue; }
+            int r = ts_append_tick(&st, f[1], field, t, v);
+            if (r < 0) rc = -1;
+            else if (r > 0) ++stale;
+            else ++added;
+        }
+        for (size_t s = 0; rc == 0 && s < st.n_series; ++s) rc = ts_flush_series(&st, (int)s);
+        if (reopened > 0) {
+            if (rc == 0 && ts_journal_commit(st.out, st.len) != 0) rc = -1;
+            if (st.out && fclose(st.out) != 0) rc = -1;
+            st.out = NULL;
+            if (rc == 0) rc = ts_journal_recover(argv[0]);
+            else unlink(jpath);
+        } else if (st.out && (fflush(st.out) != 0 || fsync(fileno(st.out)) != 0)) {
+            rc = -1;
+        }
+        double t1 = now_seconds();
+        if (in != stdin) fclose(in);
+        if (rc != 0) perror(argv[0]);
+        fprintf(stderr, "appended %zu ticks (%zu out of order, %zu malformed skipped) in %.3f ms\n",
+                added, stale, bad, (t1 - t0) * 1e3);
+    } else if (scan) {
+        int field = wal_field(argv[2]), s = field < 0 ? -1 : ts_series_find(&st, argv[1], field);
+        if (s < 0) {
+            fprintf(stderr, "no series %s / %s\n", argv[1], argv[2]);
+            rc = -1;
+        } else {
+            double t0 = now_seconds();
+            size_t n = ts_scan(&st, s, from, to, ts_print_tick, NULL);
+            fprintf(stderr, "%zu ticks in %.3f ms\n", n, (now_seconds() - t0) * 1e3);
+        }
+    } else {
+        uint64_t ticks = 0, blocks = 0;
+        for (size_t s = 0; s < st.n_series; ++s) {
+            ticks += st.series[s].ticks;
+            blocks += st.series[s].n_blocks;
+        }
+        printf("%zu series, %llu blocks, %llu ticks, %zu bytes (%.2f bytes/tick, %.1f ticks/block)\n",
+               st.n_series, (unsigned long long)blocks, (unsigned long long)ticks, st.len,
+               ticks ? (double)st.len / (double)ticks : 0.0, blocks ? (double)ticks / (double)blocks : 0.0);
+    }
+
+    ts_close(&st);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== CLOSING LINE VALUE ========================*/
+
+/* CLV of every historical projection. Our position is the side the
+ * projection takes against the line we projected from (player_line_pts),
+ * and CLV = (close - line) on an over, (line - close) on an under, in
+ * points, so a positive mean means the market moved toward us. The
+ * closing line is the store's 'close' column or, with --ticks, the last
+ * 'line' tick for the player at or before tip (end of day when the tip is
+ * unknown). Rows without a close, ruled out, or projected exactly on the
+ * line take no position.
+ *
+ * Results are grouped by factor regime: venue, back-to-back, pace bucket
+ * and DvP bucket. The group-by runs on numa_run shards: each shard
+ * projects its rows, looks up closes (the tick store is read-only), and
+ * accumulates sums into its own cells without sharing; the small
+ * per-shard tables are merged under a lock at the end. */
+typedef enum { CLV_ALL, CLV_VENUE, CLV_B2B, CLV_PACE, CLV_DVP, N_CLV_DIMS } ClvDim;
+
+#define CLV_MAX_BUCKETS 4
+
+static const char *const CLV_DIM_NAMES[N_CLV_DIMS] = { "all", "venue", "b2b", "pace", "dvp" };
+static const char *const CLV_BUCKET_NAMES[N_CLV_DIMS][CLV_MAX_BUCKETS] = {
+    { "all" },
+    { "away", "home" },
+    { "rested", "b2b" },
+    { "<97", "97-100", "100-103", "103+" },
+    { "<21", "21-23", "23-25", "25+" },
+};
+static const int CLV_N_BUCKETS[N_CLV_DIMS] = { 1, 2, 2, 4, 4 };
+static const double CLV_PACE_EDGES[3] = { 97.0, 100.0, 103.0 };
+static const double CLV_DVP_EDGES[3]  = { 21.0, 23.0, 25.0 };
+
+typedef struct {
+    double n, clv, clv2, beat, push, edge;   /* sums */
+} ClvCell;
+
+typedef struct {
+    const TsStore *ticks;
+    pthread_mutex_t mu;
+    ClvCell cell[N_CLV_DIMS][CLV_MAX_BUCKETS];
+    size_t rows, no_position;
+} ClvRun;
+
+/* Decoded blocks for as-of lookups, direct-mapped by series. Lookups
+ * for the same player on nearby dates hit the same block. */
+#define TS_CACHE_SLOTS 64
+
+typedef struct {
+    int series;                    /* -1 = empty */
+    size_t block;
+    int64_t t[TS_BLOCK_TICKS];
+    double v[TS_BLOCK_TICKS];
+} TsBlockCache;
+
+/* Last value of series s at or before t; NAN if none */
+static double ts_value_at(const TsStore *st, int s, int64_t t, TsBlockCache *cache) {
+    const TsSeries *ts = &st->series[s];
+    size_t lo = 0, hi = ts->n_blocks;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (ts->blocks[mid].t_first <= t) lo = mid + 1; else hi = mid;
+    }
+    if (lo == 0) return NAN;
+    const TsBlockRef *b = &ts->blocks[lo - 1];
+    TsBlockCache *slot = &cache[(unsigned)s % TS_CACHE_SLOTS];
+    if (slot->series != s || slot->block != lo - 1) {
+        ts_decode(b, (const uint8_t *)st->base + b->offset, slot->t, slot->v);
+        slot->series = s;
+        slot->block = lo - 1;
+    }
+    size_t a = 0, e = b->count;           /* first tick > t */
+    while (a < e) {
+        size_t mid = (a + e) / 2;
+        if (slot->t[mid] <= t) a = mid + 1; else e = mid;
+    }
+    return a > 0 ? slot->v[a - 1] : NAN;
+}
+
+static int clv_bucket(const double *edges, double x) {
+    return (x >= edges[0]) + (x >= edges[1]) + (x >= edges[2]);
+}
+
+static int clv_shard(const InputColumns *local, size_t src_begin, void *ctx) {
+    ClvRun *run = ctx;
+    ClvCell cell[N_CLV_DIMS][CLV_MAX_BUCKETS];
+    OutputColumns o;
+    TsBlockCache *cache = run->ticks ? malloc(TS_CACHE_SLOTS * sizeof(*cache)) : NULL;
+    size_t skipped = 0;
+    (void)src_begin;
+    memset(cell, 0, sizeof(cell));
+    if (run->ticks && !cache) return -1;
+    if (output_columns_alloc(&o, local->n) != 0) {
+        free(cache);
+        output_columns_free(&o);
+        return -1;
+    }
+    for (int k = 0; cache && k < TS_CACHE_SLOTS; ++k) cache[k].series = -1;
+    project_batch(local, 0, local->n, PROFILE_PER_ROW, &o);
+
+    int line_field = run->ticks ? wal_field("line") : -1;
+    for (size_t i = 0; i < local->n; ++i) {
+        double line = local->player_line_pts[i], close = local->closing_line[i];
+        if (run->ticks) {
+            int s = ts_series_find(run->ticks, local->player_name[i], line_field);
+            double tip = isnan(local->tipoff[i]) ? 2359.0 : local->tipoff[i];
+            int64_t at = (int64_t)days_from_yyyymmdd((long)local->game_date[i]) * 86400 +
+                         (int64_t)(tip / 100) * 3600 + (int64_t)fmod(tip, 100.0) * 60 + (isnan(local->tipoff[i]) ? 59 : 0);
+            double v = s >= 0 ? ts_value_at(run->ticks, s, at, cache) : NAN;
+            if (!isnan(v)) close = v;
+        }
+        double side = (o.projection[i] > line) - (o.projection[i] < line);
+        if (isnan(close) || isnan(line) || local->is_out[i] != 0.0 || side == 0.0) { ++skipped; continue; }
+
+        double clv = side * (close - line);
+        int bucket[N_CLV_DIMS] = {
+            0, local->is_home[i] != 0.0, local->is_back_to_back[i] != 0.0,
+            clv_bucket(CLV_PACE_EDGES, local->matchup_pace[i]),
+            clv_bucket(CLV_DVP_EDGES, local->opp_pts_allowed_vs_pos[i]),
+        };
+        for (int d = 0; d < N_CLV_DIMS; ++d) {
+            ClvCell *c = &cell[d][bucket[d]];
+            c->n += 1.0;
+            c->clv += clv;
+            c->clv2 += clv * clv;
+            c->beat += clv > 0.0;
+            c->push += clv == 0.0;
+            c->edge += fabs(o.projection[i] - line);
+        }
+    }
+    output_columns_free(&o);
+    free(cache);
+
+    pthread_mutex_lock(&run->mu);
+    for (int d = 0; d < N_CLV_DIMS; ++d)
+        for (int b = 0; b < CLV_MAX_BUCKETS; ++b) {
+            ClvCell *dst = &run->cell[d][b];
+            const ClvCell *src = &cell[d][b];
+            dst->n += src->n;
+            dst->clv += src->clv;
+            dst->clv2 += src->clv2;
+            dst->beat += src->beat;
+            dst->push += src->push;
+            dst->edge += src->edge;
+        }
+    run->rows += local->n;
+    run->no_position += skipped;
+    pthread_mutex_unlock(&run->mu);
+    return 0;
+}
+
+static int cmd_clv(int argc, char **argv) {
+    int n_threads = 0;
+    const char *ticks_path = NULL;
+    while (argc >= 2 && strncmp(argv[0], "--", 2) == 0) {
+        if (strcmp(argv[0], "--threads") == 0)    n_threads = atoi(argv[1]);
+        else if (strcmp(argv[0], "--ticks") == 0) ticks_path = argv[1];
+        else break;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 1) {
+        fprintf(stderr, "usage: points_model clv [--threads N] [--ticks store.tss] <store|slate>\n");
+        return 2;
+    }
+
+    InputColumns c;
+    Snapshot snap;
+    TsStore ticks;
+    memset(&ticks, 0, sizeof(ticks));
+    if (slate_open(argv[0], &c, &snap) != 0) return 1;
+    if (ticks_path && ts_open(ticks_path, &ticks) != 0) {
+        ts_close(&ticks);
+        columns_free(&c);
+        snapshot_close(&snap);
+        return 1;
+    }
+
+    ClvRun run;
+    memset(&run, 0, sizeof(run));
+    run.ticks = ticks_path ? &ticks : NULL;
+    pthread_mutex_init(&run.mu, NULL);
+    double t0 = now_seconds();
+    int rc = numa_run(&c, n_threads, clv_shard, &run);
+    double t1 = now_seconds();
+
+    if (rc == 0) {
+        printf("%-6s %-8s %9s %8s %8s %7s %7s %7s %7s\n", "regime", "bucket", "n", "clv", "sd", "t",
+               "beat%", "push%", "|edge|");
+        for (int d = 0; d < N_CLV_DIMS; ++d)
+            for (int b = 0; b < CLV_N_BUCKETS[d]; ++b) {
+                const ClvCell *k = &run.cell[d][b];
+                if (k->n == 0.0) continue;
+                double mean = k->clv / k->n, var = k->clv2 / k->n - mean * mean;
+                double sd = sqrt(var > 0.0 ? var * k->n / (k->n > 1.0 ? k->n - 1.0 : 1.0) : 0.0);
+                printf("%-6s %-8s %9.0f %+8.4f %8.4f %+7.2f %7.2f %7.2f %7.3f\n", CLV_DIM_NAMES[d],
+                       CLV_BUCKET_NAMES[d][b], k->n, mean, sd, sd > 0.0 ? mean / (sd / sqrt(k->n)) : 0.0,
+                       100.0 * k->beat / k->n, 100.0 * k->push / k->n, k->edge / k->n);
+            }
+        fprintf(stderr, "%zu rows (%zu without a position) in %.3f ms%s\n", run.rows, run.no_position,
+                (t1 - t0) * 1e3, ticks_path ? ", closes from the tick store" : "");
+    }
+
+    pthread_mutex_destroy(&run.mu);
+    ts_close(&ticks);
+    columns_free(&c);
+    snapshot_close(&snap);
+    return rc == 0 ? 0 : 1;
+}
+
+/*======================== DEMO / INTERACTIVE ========================*/
+
+static void print_output(const Inputs *in, const Output *o) {
+    printf("\nProjection for %s (%s profile)\n", in->player_name,
+           ARCHETYPE_SCALES[profile_for(in->archetype) - WEIGHT_PROFILES].name);
+    printf("Base points (blend): %.2f\n", o->base_points);
+    printf("Multipliers:\n");
+    printf("  Home/Away         : %.4f\n", o->mult_homeaway);
+    printf("  Game Total (OU)   : %.4f\n", o->mult_game_total);
+    printf("  Team Total (OU)   : %.4f\n", o->mult_team_total);
+    printf("  Def vs Position   : %.4f\n", o->mult_def_pos);
+    printf("  Recent Form       : %.4f\n", o->mult_recent);
+    printf("  Minutes Trend     : %.4f\n", o->mult_minutes);
+    printf("  Pace              : %.4f\n", o->mult_pace);
+    printf("  Back-to-Back      : %.4f\n", o->mult_b2b);
+    printf("  Blowout (spread)  : %.4f\n", o->mult_blowout);
+    printf("  Usage (teammates) : %.4f\n", o->mult_usage);
+    printf("Uncapped Multiplier : %.4f\n", o->uncapped_multiplier);
+    printf("Final Multiplier    : %.4f  (capped to [%.2f, %.2f])\n", o->final_multiplier, MULT_MIN, MULT_MAX);
+    printf("Overtime mixture    : %.4f  (P(OT) %.3f)\n", o->mult_overtime, o->ot_probability);
+    printf("Projected Points    : %.2f\n\n", o->projection);
+}
+
+static int run_interactive(void) {
+    Inputs in;
+    memset(&in, 0, sizeof(in));
+    in.usage_multiplier = 1.0;
+
+    /* === Prompt user for inputs from terminal === */
+    char namebuf[128];
+    printf("Player name: ");
+    if (!fgets(namebuf, sizeof(namebuf), stdin)) return 0;
+    /* strip newline */
+    for (int i = 0; namebuf[i]; ++i) { if (namebuf[i] == '\n') { namebuf[i] = 0; break; } }
+    in.player_name = namebuf;
+
+    printf("Sportsbook line (points): ");
+    scanf("%lf", &in.player_line_pts);
+
+    printf("Season avg points: ");
+    scanf("%lf", &in.season_avg_pts);
+
+    printf("Is home? (1=yes, 0=no): ");
+    scanf("%d", &in.is_home);
+
+    printf("Game total O/U: ");
+    scanf("%lf", &in.game_total_ou);
+
+    printf("Team total O/U: ");
+    scanf("%lf", &in.team_total_ou);
+
+    printf("Opponent points allowed to this position (per game): ");
+    scanf("%lf", &in.opp_pts_allowed_vs_pos);
+
+    /* Optional extras (enter season values again to neutralize effects) */
+    printf("Recent avg points (last N; enter season avg to ignore): ");
+    scanf("%lf", &in.recent_avg_pts);
+
+    printf("Season avg minutes: ");
+    scanf("%lf", &in.season_avg_minutes);
+
+    printf("Expected minutes this game: ");
+    scanf("%lf", &in.expected_minutes);
+
+    printf("Matchup pace (possessions per team): ");
+    scanf("%lf", &in.matchup_pace);
+
+    printf("Back-to-back? (1=yes, 0=no): ");
+    scanf("%d", &in.is_back_to_back);
+
+    char archbuf[32] = "";
+    printf("Position or archetype (PG/SG/SF/PF/C, usage_guard, bench_big, ...; - for global): ");
+    scanf("%31s", archbuf);
+    in.archetype = archetype_from_name(archbuf);
+
+    /* Compute & print */
+    Output out = project(&in);
+    print_output(&in, &out);
+
+    /* Tip: tweak the weights/constants at the top to calibrate your model
+       to historical data or to your personal handicapping philosophy. */
+
+    return 0;
+}
+
+/* Subcommands: name, handler (gets the arguments after the name), help */
+static const struct {
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *args;
+    const char *help;
+} COMMANDS[] = {
+    { "batch",    cmd_batch,    "[--minutes] [--threads N] <slate.csv>", "project every row of a slate file" },
+    { "stats",    cmd_stats,    "[--minutes] <slate.csv>", "project points, rebounds, assists, threes and combos" },
+    { "sim",      cmd_sim,      "[--n N] [--seed S] [--threads N] <slate.csv>", "Monte Carlo points distribution with OT mixture" },
+    { "pipeline", cmd_pipeline, "[--n N] [--threads N] ... <slate.csv> [out]",
+                                "streamed, stage-parallel batch / sim for large files" },
+    { "precompute", cmd_precompute, "[--n N] [--threads N] <slate.csv> <out.snap>",
+                                "stage tomorrow's projections and sims at idle priority" },
+    { "odds",     cmd_odds,     "[--n N] <slate|store>",   "no-vig market P(over) by method vs the model, with EV" },
+    { "diff",     cmd_diff,     "[--delta out.delta] [--out new.snap] <old> <new>",
+                                "recompute only players whose inputs changed" },
+    { "asof",     cmd_asof,     "[--at HHMM] [--out out.snap] <slate> <features.csv>",
+                                "rebuild inputs from point-in-time feature values" },
+    { "wal",      cmd_wal,      "append|replay|compact ...",
+                                "event-sourced input log: record, rebuild any moment, compact" },
+    { "tree",     cmd_tree,     "<model> <slate.csv>",     "score a slate with a tree ensemble dump" },
+    { "ensemble", cmd_ensemble, "<spec> <slate.csv>",      "blend several models in one pass" },
+    { "scratch",  cmd_scratch,  "<slate.csv> <players>",   "rule players out, redistribute to teammates" },
+    { "live",     cmd_live,     "<slate.csv> [events]",    "update final-points projections from an event stream" },
+    { "books",    cmd_books,    "[--consensus median|mean] [--weights b=w,...] <slate> [updates]",
+                                "stream multi-book quotes into a consensus line" },
+    { "edges",    cmd_edges,    "[--k K] [--every N] <slate> [quotes]",
+                                "keep the top-K (player, book, side) edges as quotes move" },
+    { "schedule", cmd_schedule, "[--fifo] [--n N] [--scale S] <slate.csv> <updates>",
+                                "replay updates under tip-off deadline scheduling" },
+    { "serve",    cmd_serve,    "[--socket path] [--budget-us U] [--max-batch N]",
+                                "micro-batched projection service on a Unix socket" },
+    { "snapshot", cmd_snapshot, "<slate.csv> <out.snap>",  "write a date-sorted mmappable column store" },
+    { "ingest",   cmd_ingest,   "[--threads N] [--no-uring] <out.snap> <files...>",
+                                "bulk-load many slate files into a store" },
+    { "ticks",    cmd_ticks,    "append|scan|stats ...",   "compressed line-movement history: append, range scan" },
+    { "clv",      cmd_clv,      "[--threads N] [--ticks store.tss] <store>",
+                                "closing-line value of past projections by factor regime" },
+    { "backtest", cmd_backtest, "[--workers N] [--days D] [--profiles list] <store.snap>",
+                                "replay a history store across worker processes" },
+};
+#define N_COMMANDS (sizeof(COMMANDS) / sizeof(COMMANDS[0]))
+
+static void usage(void) {
+    fprintf(stderr, "usage: points_model [--curves <file>] [--devig mult|power|shin] [command]\n");
+    fprintf(stderr, "  %-40s %s\n", "(no command)", "interactive, one player");
+    for (size_t k = 0; k < N_COMMANDS; ++k) {
+        char lhs[64];
+        snprintf(lhs, sizeof(lhs), "%s %s", COMMANDS[k].name, COMMANDS[k].args);
+        fprintf(stderr, "  %-40s %s\n", lhs, COMMANDS[k].help);
+    }
+}
+
+int main(int argc, char **argv) {
+    weights_init();
+    blowout_init();
+
+    /* Global options come before the command */
+    int a = 1;
+    while (a < argc && strncmp(argv[a], "--", 2) == 0) {
+        if (strcmp(argv[a], "--curves") == 0 && a + 1 < argc) {
+            if (curves_load(argv[a + 1]) != 0) return 1;
+            a += 2;
+        } else if (strcmp(argv[a], "--devig") == 0 && a + 1 < argc) {
+            int m = 0;
+            while (m < N_DEVIG_METHODS && strcmp(argv[a + 1], DEVIG_NAMES[m]) != 0) ++m;
+            if (m == N_DEVIG_METHODS) { usage(); return 2; }
+            DEVIG_METHOD = (DevigMethod)m;
+            a += 2;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    argc -= a;
+    argv += a;
+
+    if (argc == 0) return run_interactive();
+    for (size_t k = 0; k < N_COMMANDS; ++k)
+        if (strcmp(argv[0], COMMANDS[k].name) == 0) return COMMANDS[k].run(argc - 1, argv + 1);
+    usage();
+    return 2;
+}